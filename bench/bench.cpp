@@ -0,0 +1,171 @@
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+#include <sys/stat.h>
+
+#include "thomas/thomas.hpp"
+
+//  Measures the loader and reduction throughput over the given files. Each
+//  file is loaded and reduced repeatedly as the command line tool does, into
+//  an edge list analyzed over its narrowest compressed rows, and the best run
+//  is reported. With
+//  --batch=N, N random assignment sized networks are reduced one by one and
+//  as a batch, and the throughput is reported in graphs per second.
+
+inline bool parse_option(const std::string &argument, const char *name, uint64_t &value) {
+    const char *cursor = argument.data() + std::strlen(name);
+    const char *end = argument.data() + argument.size();
+
+    return thomas::parse_unsigned(cursor, end, value) && cursor == end;
+}
+
+void bench_batch(const uint64_t count) {
+    using clock = std::chrono::steady_clock;
+
+    std::mt19937_64 engine(count);
+    std::vector<std::unique_ptr<thomas::network>> networks;
+    thomas::graph_batch batch;
+    std::vector<uint32_t> pairs(2000);
+
+    batch.reserve(count, count * 1000);
+
+    for (uint64_t g = 0; g < count; ++g) {
+        auto network = std::make_unique<thomas::network>();
+
+        for (size_t i = 0; i < pairs.size(); ++i) {
+            pairs[i] = static_cast<uint32_t>(engine() % 1000);
+        }
+
+        for (size_t i = 0; i < pairs.size(); i += 2) {
+            network->connect(pairs[i] + 1, pairs[i + 1] + 1);
+        }
+
+        batch.add_network(*network);
+        networks.push_back(std::move(network));
+    }
+
+    std::vector<uint64_t> results(count);
+    uint64_t checksum = 0;
+
+    const auto single_start = clock::now();
+
+    for (auto &each_network : networks) {
+        checksum += each_network->reduce();
+    }
+
+    const auto batch_start = clock::now();
+    thomas::reduce_batch(batch, results.data());
+    const auto batch_end = clock::now();
+
+    for (auto &each_result : results) {
+        checksum -= each_result;
+    }
+
+    const double single = std::chrono::duration<double>(batch_start - single_start).count();
+    const double batched = std::chrono::duration<double>(batch_end - batch_start).count();
+
+    std::cout << "network::reduce()  " << std::fixed << std::setprecision(0) << static_cast<double>(count) / single << " graphs/s" << std::endl;
+    std::cout << "reduce_batch()     " << static_cast<double>(count) / batched << " graphs/s" << std::endl;
+
+    if (checksum != 0) {
+        std::cerr << "error: batched results differ" << std::endl;
+    }
+}
+
+//  Results of the reductions, which have to stay observable
+volatile uint64_t sink = 0;
+
+int32_t main(int32_t argc, const char * argv[]) {
+    using clock = std::chrono::steady_clock;
+
+    uint64_t repeat = 5, batch = 0;
+    thomas::header_mode header = thomas::header_mode::trust;
+    int32_t first = 1;
+
+    for (; first < argc && std::strncmp(argv[first], "--", 2) == 0; ++first) {
+        const std::string argument = argv[first];
+
+        if (!(argument.compare(0, 9, "--repeat=") == 0 && parse_option(argument, "--repeat=", repeat)) &&
+            !(argument.compare(0, 8, "--batch=") == 0 && parse_option(argument, "--batch=", batch)) &&
+            !(argument.compare(0, 9, "--header=") == 0 && thomas::header_mode_from_name(argument.substr(9), header))) {
+            std::cerr << "usage: thomas_bench [--repeat=N] [--header=MODE] [--batch=N] files..." << std::endl;
+            return 1;
+        }
+    }
+
+    if (batch != 0) {
+        bench_batch(batch);
+    }
+
+    if (first == argc) {
+        return 0;
+    }
+
+    std::cout << std::left << std::setw(32) << "file"
+              << std::right << std::setw(12) << "roads"
+              << std::setw(14) << "load MB/s"
+              << std::setw(16) << "load roads/s"
+              << std::setw(14) << "reduce/s" << std::endl;
+
+    for (int32_t i = first; i < argc; ++i) {
+        const std::string path = argv[i];
+        const thomas::format format = thomas::format_from_path(path);
+        struct stat status;
+
+        if (stat(path.c_str(), &status) != 0 || format == thomas::format::arrow) {
+            std::cerr << "io error: \"" << path << "\" can't be benchmarked" << std::endl;
+            return 2;
+        }
+
+        double best_load = 0, best_reduce = 0;
+        uint64_t roads = 0, checksum = 0;
+
+        for (uint64_t run = 0; run < repeat; ++run) {
+            thomas::edge_list edges;
+            thomas::error_buffer errors;
+            thomas::input in(path.c_str());
+
+            const auto load_start = clock::now();
+
+            if (thomas::import(format, in, edges, errors, header) != thomas::status::ok) {
+                std::cerr << errors;
+                return 3;
+            }
+
+            const auto load_end = clock::now();
+            checksum += thomas::visit_narrowest(edges, [] (const auto &compressed) {
+                std::vector<uint64_t> impacts;
+                std::vector<size_t> disposed;
+
+                return thomas::analyze(compressed, impacts, disposed).disposed();
+            });
+            const auto reduce_end = clock::now();
+
+            const double load = std::chrono::duration<double>(load_end - load_start).count();
+            const double reduce = std::chrono::duration<double>(reduce_end - load_end).count();
+
+            best_load = run == 0 ? load : std::min(best_load, load);
+            best_reduce = run == 0 ? reduce : std::min(best_reduce, reduce);
+            roads = edges.number_of_roads();
+        }
+
+        const std::string name = path.substr(path.find_last_of('/') + 1);
+
+        std::cout << std::left << std::setw(32) << name
+                  << std::right << std::setw(12) << roads
+                  << std::setw(14) << std::fixed << std::setprecision(1) << static_cast<double>(status.st_size) / best_load / 1e6
+                  << std::setw(16) << std::setprecision(0) << static_cast<double>(roads) / best_load
+                  << std::setw(14) << 1.0 / best_reduce << std::endl;
+
+        //  Keeps the reductions observable
+        sink = checksum;
+    }
+
+    return 0;
+}
@@ -0,0 +1,123 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "thomas/parse.hpp"
+
+//  Writes a synthetic network to the standard output. Endpoints are drawn with
+//  a tunable skew, so that a few shops end up with most of the roads.
+
+inline bool parse_option(const std::string &argument, const char *name, uint64_t &value) {
+    const char *cursor = argument.data() + std::strlen(name);
+    const char *end = argument.data() + argument.size();
+
+    return thomas::parse_unsigned(cursor, end, value) && cursor == end;
+}
+
+int32_t main(int32_t argc, const char * argv[]) {
+    std::string format = "native";
+    uint64_t num_shops = 1000, num_roads = 1000, seed = 1, skew = 1;
+
+    for (int32_t i = 1; i < argc; ++i) {
+        const std::string argument = argv[i];
+
+        if (argument.compare(0, 9, "--format=") == 0) {
+            format = argument.substr(9);
+        } else if (!(argument.compare(0, 8, "--shops=") == 0 && parse_option(argument, "--shops=", num_shops)) &&
+                   !(argument.compare(0, 8, "--roads=") == 0 && parse_option(argument, "--roads=", num_roads)) &&
+                   !(argument.compare(0, 7, "--seed=") == 0 && parse_option(argument, "--seed=", seed)) &&
+                   !(argument.compare(0, 7, "--skew=") == 0 && parse_option(argument, "--skew=", skew))) {
+            std::cerr << "usage: thomas_generate [--format=native|snap|metis|mtx] [--shops=N] [--roads=M] [--seed=S] [--skew=K]" << std::endl;
+            return 1;
+        }
+    }
+
+    if (num_shops < 2 || skew < 1) {
+        std::cerr << "argument error: at least two shops and a skew of one are required" << std::endl;
+        return 1;
+    }
+
+    std::mt19937_64 engine(seed);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+
+    const auto draw = [&] () -> uint64_t {
+        double value = uniform(engine);
+
+        for (uint64_t k = 1; k < skew; ++k) {
+            value *= uniform(engine);
+        }
+
+        return std::min<uint64_t>(num_shops - 1, static_cast<uint64_t>(value * static_cast<double>(num_shops))) + 1;
+    };
+
+    std::vector<std::pair<uint64_t, uint64_t>> roads;
+    roads.reserve(num_roads);
+
+    for (uint64_t i = 0; i < num_roads; ++i) {
+        uint64_t from = draw(), to = draw();
+
+        while (to == from) {
+            to = draw();
+        }
+
+        roads.emplace_back(from, to);
+    }
+
+    std::ios::sync_with_stdio(false);
+
+    if (format == "native" || format == "snap") {
+        if (format == "native") {
+            std::cout << num_shops << " " << num_roads << "\n";
+        } else {
+            std::cout << "# synthetic network, seed " << seed << "\n# FromNodeId\tToNodeId\n";
+        }
+
+        for (auto &each_road : roads) {
+            std::cout << each_road.first << (format == "native" ? " " : "\t") << each_road.second << "\n";
+        }
+    } else if (format == "mtx") {
+        std::cout << "%%MatrixMarket matrix coordinate pattern symmetric\n";
+        std::cout << num_shops << " " << num_shops << " " << num_roads << "\n";
+
+        for (auto &each_road : roads) {
+            std::cout << std::max(each_road.first, each_road.second) << " " << std::min(each_road.first, each_road.second) << "\n";
+        }
+    } else if (format == "metis") {
+        //  METIS expects a simple graph listing every edge from both ends
+        for (auto &each_road : roads) {
+            if (each_road.first > each_road.second) {
+                std::swap(each_road.first, each_road.second);
+            }
+        }
+
+        std::sort(roads.begin(), roads.end());
+        roads.erase(std::unique(roads.begin(), roads.end()), roads.end());
+
+        std::vector<std::vector<uint64_t>> adjacency(num_shops + 1);
+
+        for (auto &each_road : roads) {
+            adjacency[each_road.first].push_back(each_road.second);
+            adjacency[each_road.second].push_back(each_road.first);
+        }
+
+        std::cout << num_shops << " " << roads.size() << "\n";
+
+        for (uint64_t i = 1; i <= num_shops; ++i) {
+            for (size_t j = 0; j < adjacency[i].size(); ++j) {
+                std::cout << (j == 0 ? "" : " ") << adjacency[i][j];
+            }
+
+            std::cout << "\n";
+        }
+    } else {
+        std::cerr << "argument error: unknown format \"" << format << "\"" << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,634 @@
+#ifndef THOMAS_ARROW_HPP
+#define THOMAS_ARROW_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "thomas/network.hpp"
+#include "thomas/status.hpp"
+
+namespace thomas {
+    namespace arrow {
+        /**
+         flatbuffer_builder
+         Minimal FlatBuffers encoder for the Arrow metadata. As in the reference
+         implementation the buffer is built back to front, so that children are
+         finished before their parents and every offset points forward. Values
+         are stored with the host byte order, which is expected to be little endian.
+         */
+        class flatbuffer_builder {
+        private:
+            //  Bytes from the end of the buffer towards its start
+            std::vector<uint8_t> reversed;
+            size_t max_alignment = 1;
+
+            std::vector<std::pair<uint16_t, uint32_t>> fields;
+            uint32_t table_start = 0;
+
+            inline void prepend(const void *data, const size_t length) {
+                const uint8_t *bytes = static_cast<const uint8_t *>(data);
+
+                for (size_t i = length; i != 0; --i) {
+                    reversed.push_back(bytes[i - 1]);
+                }
+            }
+
+        public:
+            inline uint32_t size() const noexcept {
+                return static_cast<uint32_t>(reversed.size());
+            }
+
+            /**
+             align()
+             Pads the buffer so that an object of the given length prepended next ends up aligned.
+             */
+            inline void align(const size_t length, const size_t alignment) {
+                max_alignment = std::max(max_alignment, alignment);
+
+                while ((reversed.size() + length) % alignment != 0) {
+                    reversed.push_back(0);
+                }
+            }
+
+            template <typename T>
+            inline uint32_t scalar(const T value) {
+                align(sizeof(T), sizeof(T));
+                prepend(&value, sizeof(T));
+
+                return size();
+            }
+
+            inline uint32_t offset(const uint32_t target) {
+                align(4, 4);
+
+                return scalar<uint32_t>(size() + 4 - target);
+            }
+
+            inline uint32_t string(const std::string &value) {
+                align(value.size() + 1, 4);
+                reversed.push_back(0);
+                prepend(value.data(), value.size());
+
+                return scalar<uint32_t>(static_cast<uint32_t>(value.size()));
+            }
+
+            inline uint32_t struct_vector(const void *data, const size_t count, const size_t element_size) {
+                align(count * element_size, 8);
+                prepend(data, count * element_size);
+
+                return scalar<uint32_t>(static_cast<uint32_t>(count));
+            }
+
+            inline uint32_t offset_vector(const std::vector<uint32_t> &targets) {
+                align(targets.size() * 4, 4);
+
+                for (auto it = targets.rbegin(); it != targets.rend(); ++it) {
+                    offset(*it);
+                }
+
+                return scalar<uint32_t>(static_cast<uint32_t>(targets.size()));
+            }
+
+            inline void start_table() {
+                fields.clear();
+                table_start = size();
+            }
+
+            template <typename T>
+            inline void add_scalar(const uint16_t field, const T value) {
+                fields.emplace_back(field, scalar<T>(value));
+            }
+
+            inline void add_offset(const uint16_t field, const uint32_t target) {
+                fields.emplace_back(field, offset(target));
+            }
+
+            /**
+             end_table()
+             Writes the table header and its vtable right in front of it.
+
+             @return The reference to the table.
+             */
+            inline uint32_t end_table() {
+                const uint32_t table = scalar<int32_t>(0);
+                uint16_t count = 0;
+
+                for (auto &each_field : fields) {
+                    count = std::max<uint16_t>(count, each_field.first + 1);
+                }
+
+                std::vector<uint16_t> entries(count, 0);
+
+                for (auto &each_field : fields) {
+                    entries[each_field.first] = static_cast<uint16_t>(table - each_field.second);
+                }
+
+                for (size_t i = count; i != 0; --i) {
+                    scalar<uint16_t>(entries[i - 1]);
+                }
+
+                scalar<uint16_t>(static_cast<uint16_t>(table - table_start));
+                scalar<uint16_t>(static_cast<uint16_t>((count + 2) * 2));
+
+                //  The table refers to its vtable with a signed distance backwards
+                const int32_t distance = static_cast<int32_t>(size() - table);
+                uint8_t bytes[4];
+                std::memcpy(bytes, &distance, sizeof(bytes));
+
+                for (size_t j = 0; j < sizeof(bytes); ++j) {
+                    reversed[table - 1 - j] = bytes[j];
+                }
+
+                return table;
+            }
+
+            inline std::vector<uint8_t> finish(const uint32_t root) {
+                align(4, max_alignment);
+                offset(root);
+
+                return std::vector<uint8_t>(reversed.rbegin(), reversed.rend());
+            }
+        };
+
+        /**
+         flatbuffer_table
+         Bounds checked view over a table of a FlatBuffers encoded buffer.
+         */
+        class flatbuffer_table {
+        private:
+            const uint8_t *data = nullptr;
+            size_t size = 0;
+            size_t position = 0;
+            bool valid = false;
+
+            template <typename T>
+            inline bool read(const size_t at, T &value) const noexcept {
+                if (at > size || size - at < sizeof(T)) {
+                    return false;
+                }
+
+                std::memcpy(&value, data + at, sizeof(T));
+
+                return true;
+            }
+
+            inline size_t field(const uint16_t id) const noexcept {
+                int32_t distance;
+                uint16_t vtable_size, field_offset;
+
+                if (!valid || !read(position, distance)) {
+                    return 0;
+                }
+
+                const size_t vtable = position - static_cast<size_t>(static_cast<int64_t>(distance));
+
+                if (!read(vtable, vtable_size) || 4u + 2u * id + 2u > vtable_size || !read(vtable + 4 + 2 * id, field_offset)) {
+                    return 0;
+                }
+
+                return field_offset == 0 ? 0 : position + field_offset;
+            }
+
+            inline size_t follow(const uint16_t id) const noexcept {
+                const size_t at = field(id);
+                uint32_t distance;
+
+                if (at == 0 || !read(at, distance) || at + distance >= size) {
+                    return 0;
+                }
+
+                return at + distance;
+            }
+
+        public:
+            flatbuffer_table() = default;
+
+            flatbuffer_table(const uint8_t *data, const size_t size, const size_t position)
+                : data(data), size(size), position(position), valid(position != 0 && position < size) {
+                //  Empty implementation
+            }
+
+            static inline flatbuffer_table root(const uint8_t *data, const size_t size) noexcept {
+                uint32_t distance;
+
+                if (size < 4) {
+                    return flatbuffer_table();
+                }
+
+                std::memcpy(&distance, data, sizeof(distance));
+
+                return flatbuffer_table(data, size, distance);
+            }
+
+            inline bool is_valid() const noexcept {
+                return valid;
+            }
+
+            template <typename T>
+            inline T scalar(const uint16_t id, const T fallback) const noexcept {
+                const size_t at = field(id);
+                T value;
+
+                return at != 0 && read(at, value) ? value : fallback;
+            }
+
+            inline flatbuffer_table table(const uint16_t id) const noexcept {
+                const size_t at = follow(id);
+
+                return at == 0 ? flatbuffer_table() : flatbuffer_table(data, size, at);
+            }
+
+            /**
+             vector()
+             Locates the elements of a vector field, each being element_size bytes.
+
+             @return Whether the vector is present and lies within the buffer.
+             */
+            inline bool vector(const uint16_t id, const size_t element_size, const uint8_t *&elements, uint32_t &length) const noexcept {
+                const size_t at = follow(id);
+
+                if (at == 0 || !read(at, length) || (size - at - 4) / element_size < length) {
+                    return false;
+                }
+
+                elements = data + at + 4;
+
+                return true;
+            }
+
+            inline flatbuffer_table table_at(const uint8_t *elements, const uint32_t index) const noexcept {
+                uint32_t distance;
+                const size_t at = static_cast<size_t>(elements - data) + 4 * index;
+
+                if (!read(at, distance) || at + distance >= size) {
+                    return flatbuffer_table();
+                }
+
+                return flatbuffer_table(data, size, at + distance);
+            }
+
+            inline std::string string(const uint16_t id) const {
+                const uint8_t *characters;
+                uint32_t length;
+
+                if (!vector(id, 1, characters, length)) {
+                    return std::string();
+                }
+
+                return std::string(reinterpret_cast<const char *>(characters), length);
+            }
+        };
+
+        enum class type : uint8_t {
+            uint64,
+            boolean
+        };
+
+        struct column {
+            std::string name;
+            arrow::type type;
+
+            //  Values buffer, uint64 values or a bitmap for booleans
+            const void *values;
+        };
+
+        //  Schema.fbs and Message.fbs constants
+        static constexpr int16_t metadata_version = 4;
+        static constexpr uint8_t header_schema = 1;
+        static constexpr uint8_t header_record_batch = 3;
+        static constexpr uint8_t type_int = 2;
+        static constexpr uint8_t type_bool = 6;
+
+        static constexpr size_t buffer_alignment = 64;
+        static constexpr char magic[] = "ARROW1";
+
+        struct _block {
+            int64_t offset;
+            int32_t metadata_length;
+            int32_t padding;
+            int64_t body_length;
+        };
+
+        struct _buffer {
+            int64_t offset;
+            int64_t length;
+        };
+
+        struct _field_node {
+            int64_t length;
+            int64_t null_count;
+        };
+
+        inline size_t padded(const size_t length, const size_t alignment) noexcept {
+            return (length + alignment - 1) / alignment * alignment;
+        }
+
+        inline size_t values_length(const type type, const uint64_t rows) noexcept {
+            return type == type::uint64 ? rows * sizeof(uint64_t) : (rows + 7) / 8;
+        }
+
+        /**
+         rows_fit()
+         Whether the values of the given number of rows fit into a body of the
+         given length, checked before values_length() so that it can't wrap.
+         */
+        inline bool rows_fit(const type type, const int64_t rows, const int64_t body_length) noexcept {
+            return rows >= 0 && (type == type::uint64 ? rows <= body_length / static_cast<int64_t>(sizeof(uint64_t)) : rows / 8 <= body_length);
+        }
+
+        /**
+         mapped_file
+         Read-only memory mapping of a whole file.
+         */
+        class mapped_file {
+        private:
+            const uint8_t *data = nullptr;
+            size_t size = 0;
+
+        public:
+            mapped_file() = default;
+            mapped_file(const mapped_file &) = delete;
+            mapped_file &operator=(const mapped_file &) = delete;
+
+            virtual ~mapped_file() {
+                if (data != nullptr) {
+                    munmap(const_cast<uint8_t *>(data), size);
+                }
+            }
+
+            inline bool open(const std::string &path) {
+                const int descriptor = ::open(path.c_str(), O_RDONLY);
+                struct stat status;
+
+                if (descriptor < 0) {
+                    return false;
+                }
+
+                if (fstat(descriptor, &status) != 0 || status.st_size == 0) {
+                    close(descriptor);
+                    return false;
+                }
+
+                void *mapping = mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ, MAP_PRIVATE, descriptor, 0);
+                close(descriptor);
+
+                if (mapping == MAP_FAILED) {
+                    return false;
+                }
+
+                data = static_cast<const uint8_t *>(mapping);
+                size = static_cast<size_t>(status.st_size);
+
+                return true;
+            }
+
+            inline const uint8_t *get_data() const noexcept {
+                return data;
+            }
+
+            inline size_t get_size() const noexcept {
+                return size;
+            }
+        };
+
+        /**
+         table_reader
+         Maps an Arrow IPC file and exposes its record batches without copying
+         the column buffers. Only non-nullable uint64 and bool columns are read.
+         */
+        class table_reader {
+        public:
+            struct batch {
+                uint64_t rows;
+                std::vector<const void *> values;
+            };
+
+        private:
+            mapped_file file;
+            std::vector<column> columns;
+            std::vector<batch> batches;
+
+            inline bool read_schema(const flatbuffer_table &schema, std::string &error) {
+                const uint8_t *fields;
+                uint32_t count;
+
+                if (!schema.vector(1, 4, fields, count)) {
+                    error = "schema has no fields";
+                    return false;
+                }
+
+                for (uint32_t i = 0; i < count; ++i) {
+                    const flatbuffer_table field = schema.table_at(fields, i);
+                    const flatbuffer_table field_type = field.table(3);
+                    const uint8_t type_type = field.scalar<uint8_t>(2, 0);
+                    column each_column = { field.string(0), type::uint64, nullptr };
+
+                    if (type_type == type_int && field_type.scalar<int32_t>(0, 0) == 64 && field_type.scalar<uint8_t>(1, 0) == 0) {
+                        each_column.type = type::uint64;
+                    } else if (type_type == type_bool) {
+                        each_column.type = type::boolean;
+                    } else {
+                        error = "column \"" + each_column.name + "\" is neither uint64 nor bool";
+                        return false;
+                    }
+
+                    columns.push_back(each_column);
+                }
+
+                return true;
+            }
+
+            inline bool read_batch(const _block &block, std::string &error) {
+                const uint8_t *data = file.get_data();
+                const size_t size = file.get_size();
+                uint32_t continuation;
+                int32_t length;
+
+                if (block.offset < 0 || block.metadata_length < 8 || block.body_length < 0 ||
+                    static_cast<uint64_t>(block.offset) + static_cast<uint64_t>(block.metadata_length) + static_cast<uint64_t>(block.body_length) > size) {
+                    error = "record batch block out of bounds";
+                    return false;
+                }
+
+                std::memcpy(&continuation, data + block.offset, sizeof(continuation));
+                std::memcpy(&length, data + block.offset + 4, sizeof(length));
+
+                if (continuation != 0xFFFFFFFF || length + 8 != block.metadata_length) {
+                    error = "malformed record batch message";
+                    return false;
+                }
+
+                const flatbuffer_table message = flatbuffer_table::root(data + block.offset + 8, static_cast<size_t>(length));
+                const flatbuffer_table header = message.table(2);
+                const uint8_t *nodes, *buffers;
+                uint32_t node_count, buffer_count;
+
+                if (message.scalar<uint8_t>(1, 0) != header_record_batch || !header.is_valid() ||
+                    !header.vector(1, sizeof(_field_node), nodes, node_count) ||
+                    !header.vector(2, sizeof(_buffer), buffers, buffer_count) ||
+                    node_count != columns.size() || buffer_count != 2 * columns.size()) {
+                    error = "unexpected record batch layout";
+                    return false;
+                }
+
+                if (header.table(3).is_valid()) {
+                    error = "compressed record batches are not supported";
+                    return false;
+                }
+
+                const uint8_t *body = data + block.offset + block.metadata_length;
+                const int64_t rows = header.scalar<int64_t>(0, 0);
+                batch each_batch = { static_cast<uint64_t>(rows), {} };
+
+                for (size_t i = 0; i < columns.size(); ++i) {
+                    _field_node node;
+                    _buffer values;
+
+                    std::memcpy(&node, nodes + i * sizeof(_field_node), sizeof(node));
+                    std::memcpy(&values, buffers + (2 * i + 1) * sizeof(_buffer), sizeof(values));
+
+                    if (node.length != rows || node.null_count != 0) {
+                        error = "column \"" + columns[i].name + "\" has nulls or a mismatching length";
+                        return false;
+                    }
+
+                    //  The length is compared with what is left of the body, as the sum may overflow
+                    if (!rows_fit(columns[i].type, rows, block.body_length) ||
+                        values.offset < 0 || values.length < 0 || values.length > block.body_length - values.offset ||
+                        static_cast<uint64_t>(values.length) < values_length(columns[i].type, static_cast<uint64_t>(rows)) ||
+                        reinterpret_cast<uintptr_t>(body + values.offset) % alignof(uint64_t) != 0) {
+                        error = "column \"" + columns[i].name + "\" buffer is out of bounds or misaligned";
+                        return false;
+                    }
+
+                    each_batch.values.push_back(body + values.offset);
+                }
+
+                batches.push_back(each_batch);
+
+                return true;
+            }
+
+        public:
+            /**
+             open()
+             Maps the file and validates its footer, schema and record batches.
+
+             @return The status of the read, error is set otherwise.
+             */
+            inline status open(const std::string &path, std::string &error) {
+                if (!file.open(path)) {
+                    error = "\"" + path + "\" couldn't be mapped";
+                    return status::io_error;
+                }
+
+                const uint8_t *data = file.get_data();
+                const size_t size = file.get_size();
+                int32_t footer_length;
+
+                if (size < 18 || std::memcmp(data, magic, 6) != 0 || std::memcmp(data + size - 6, magic, 6) != 0) {
+                    error = "missing ARROW1 magic";
+                    return status::parse_error;
+                }
+
+                std::memcpy(&footer_length, data + size - 10, sizeof(footer_length));
+
+                if (footer_length <= 0 || static_cast<size_t>(footer_length) > size - 18) {
+                    error = "malformed footer";
+                    return status::parse_error;
+                }
+
+                const flatbuffer_table footer = flatbuffer_table::root(data + size - 10 - footer_length, static_cast<size_t>(footer_length));
+                const uint8_t *blocks;
+                uint32_t count;
+
+                if (!footer.is_valid() || !read_schema(footer.table(1), error)) {
+                    if (error.empty()) {
+                        error = "malformed footer";
+                    }
+
+                    return status::parse_error;
+                }
+
+                if (!footer.vector(3, sizeof(_block), blocks, count)) {
+                    error = "footer has no record batches";
+                    return status::parse_error;
+                }
+
+                for (uint32_t i = 0; i < count; ++i) {
+                    _block block;
+                    std::memcpy(&block, blocks + i * sizeof(_block), sizeof(block));
+
+                    if (!read_batch(block, error)) {
+                        return status::parse_error;
+                    }
+                }
+
+                return status::ok;
+            }
+
+            inline const std::vector<column> &get_columns() const noexcept {
+                return columns;
+            }
+
+            inline const std::vector<batch> &get_batches() const noexcept {
+                return batches;
+            }
+
+            inline size_t column_index(const std::string &name, const type type) const noexcept {
+                for (size_t i = 0; i < columns.size(); ++i) {
+                    if (columns[i].name == name && columns[i].type == type) {
+                        return i;
+                    }
+                }
+
+                return columns.size();
+            }
+        };
+
+        /**
+         write_table()
+         Writes the columns as an Arrow IPC file with a single record batch. Every
+         buffer starts at a 64 byte boundary so that readers can map it directly.
+
+         @return Whether the file has been written, error is set otherwise.
+         */
+        bool write_table(const std::string &path, const std::vector<column> &columns, const uint64_t rows, std::string &error);
+
+        /**
+         export_edges()
+         Writes every road once as a (source, target) row with source <= target.
+
+         @return Whether the file has been written, error is set otherwise.
+         */
+        bool export_edges(network &network, const std::string &path, std::string &error);
+
+        /**
+         export_shops()
+         Writes the identifier, degree, impact and disposal flag of every shop, as
+         computed by network::reduce(). The impact of a shop is the total degree of
+         its neighbors outside the set of shops with the highest degree.
+
+         @return Whether the file has been written, error is set otherwise.
+         */
+        bool export_shops(network &network, const std::string &path, std::string &error);
+
+        /**
+         import_edges()
+         Connects the shops of every (source, target) row of an Arrow IPC file.
+
+         @return The status of the load, errors are collected into the buffer.
+         */
+        status import_edges(const std::string &path, network &network, error_buffer &errors);
+    }
+}
+
+#endif
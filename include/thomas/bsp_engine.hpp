@@ -0,0 +1,319 @@
+#ifndef THOMAS_BSP_ENGINE_HPP
+#define THOMAS_BSP_ENGINE_HPP
+
+#include <algorithm>
+#include <barrier>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "thomas/graph_backend.hpp"
+#include "thomas/status.hpp"
+
+namespace thomas {
+    struct min_combiner {
+        template <typename Message>
+        inline Message operator()(const Message &a, const Message &b) const noexcept {
+            return std::min(a, b);
+        }
+    };
+
+    /**
+     bsp_engine
+     Vertex centric supersteps over any backend, as in Pregel. In every
+     superstep, each active shop and each shop with a message runs the
+     compute function, which may update the value of the shop, send
+     messages for the next superstep and vote to halt. A message wakes a
+     halted shop up; the run ends when every shop halted and no message is
+     in flight.
+
+     Every thread owns a range of shops, a multiple of 64 so that the words
+     of the active and message bitmaps belong to a single thread. Messages
+     to the own range are combined into the inbox of the next superstep at
+     once, the others are buffered by the range of their target and merged
+     by its owner after the barrier, with the combiner keeping a single
+     message per shop. Shops are indexed with 32 bits.
+     */
+    template <graph_backend Graph, typename Message, typename Combiner = min_combiner>
+    class bsp_engine {
+    public:
+        class context {
+        private:
+            bsp_engine &engine;
+            unsigned thread;
+            size_t shop;
+            bool halted = false;
+
+            friend class bsp_engine;
+
+            context(bsp_engine &engine, const unsigned thread, const size_t shop) noexcept : engine(engine), thread(thread), shop(shop) {
+                //  Empty implementation
+            }
+
+        public:
+            inline size_t vertex() const noexcept {
+                return shop;
+            }
+
+            inline size_t superstep() const noexcept {
+                return engine.supersteps;
+            }
+
+            inline const Graph &graph() const noexcept {
+                return engine.graph;
+            }
+
+            inline void send(const size_t target, const Message &message) {
+                const unsigned owner = static_cast<unsigned>(target / engine.range);
+
+                if (owner == thread) {
+                    engine.deliver(target, message);
+                } else {
+                    engine.outgoing[thread * engine.ranges + owner].emplace_back(static_cast<uint32_t>(target), message);
+                }
+            }
+
+            inline void send_to_neighbors(const Message &message) {
+                for (auto each : engine.graph.neighbors(shop)) {
+                    send(static_cast<size_t>(each), message);
+                }
+            }
+
+            inline void vote_to_halt() noexcept {
+                halted = true;
+            }
+        };
+
+    private:
+        const Graph &graph;
+        Combiner combiner;
+        unsigned threads;
+
+        //  Shops per thread and number of threads of the current run
+        size_t range = 64;
+        unsigned ranges = 1;
+        size_t supersteps = 0;
+
+        //  Messages of the current and of the next superstep, with their bitmaps
+        std::vector<Message> inbox, next_inbox;
+        std::vector<uint64_t> has_message, next_has_message;
+        std::vector<uint64_t> active;
+
+        //  Messages to other ranges, sender major
+        std::vector<std::vector<std::pair<uint32_t, Message>>> outgoing;
+        std::vector<uint8_t> pending;
+
+        inline void deliver(const size_t target, const Message &message) {
+            uint64_t &word = next_has_message[target / 64];
+            const uint64_t bit = static_cast<uint64_t>(1) << (target % 64);
+
+            if ((word & bit) != 0) {
+                next_inbox[target] = combiner(next_inbox[target], message);
+            } else {
+                next_inbox[target] = message;
+                word |= bit;
+            }
+        }
+
+    public:
+        explicit bsp_engine(const Graph &graph, Combiner combiner = Combiner(), const unsigned threads = std::thread::hardware_concurrency())
+            : graph(graph), combiner(std::move(combiner)), threads(std::max(1u, threads)) {
+            //  Empty implementation
+        }
+
+        inline size_t get_supersteps() const noexcept {
+            return supersteps;
+        }
+
+        /**
+         run()
+         Runs supersteps until every shop halted without messages in flight,
+         or until the limit. Every shop is active in the first superstep. The
+         compute function is called with the context of the shop, its value
+         and its combined message, or nullptr when there is none.
+
+         @param values Value by shop, resized to the number of shops.
+         @param compute Function of (context &, Value &, const Message *).
+         @param max_supersteps Limit of the number of supersteps.
+         @return The status of the run, a range error when there are too many shops.
+         */
+        template <typename Value, typename Compute>
+        inline status run(std::vector<Value> &values, Compute &&compute, const size_t max_supersteps = SIZE_MAX) {
+            const size_t count = graph.number_of_shops();
+            const size_t words = (count + 63) / 64;
+
+            if (count > UINT32_MAX) {
+                return status::range_error;
+            }
+
+            //  Small inputs don't pay for the threads
+            unsigned workers = count < 65536 ? 1u : threads;
+
+            range = std::max<size_t>((count + workers - 1) / workers, 1);
+            range = (range + 63) / 64 * 64;
+            workers = static_cast<unsigned>(std::max<size_t>((count + range - 1) / range, 1));
+
+            values.resize(count);
+            inbox.assign(count, Message());
+            next_inbox.assign(count, Message());
+            has_message.assign(words, 0);
+            next_has_message.assign(words, 0);
+            active.assign(words, ~static_cast<uint64_t>(0));
+            outgoing.assign(static_cast<size_t>(workers) * workers, {});
+            pending.assign(workers, 0);
+            supersteps = 0;
+
+            if (count % 64 != 0) {
+                active.back() = (static_cast<uint64_t>(1) << (count % 64)) - 1;
+            }
+
+            ranges = workers;
+
+            bool proceed = count != 0 && max_supersteps != 0;
+
+            std::barrier<> computed(workers);
+            std::barrier merged(workers, [&] () noexcept {
+                inbox.swap(next_inbox);
+                has_message.swap(next_has_message);
+
+                proceed = ++supersteps < max_supersteps && std::find(pending.begin(), pending.end(), 1) != pending.end();
+            });
+
+            const auto step = [&] (const unsigned t) {
+                const size_t first = t * range / 64;
+                const size_t last = std::min(words, (t + 1) * range / 64);
+
+                while (proceed) {
+                    for (size_t w = first; w < last; ++w) {
+                        uint64_t bits = active[w] | has_message[w];
+
+                        while (bits != 0) {
+                            const size_t b = static_cast<size_t>(std::countr_zero(bits));
+                            const uint64_t bit = static_cast<uint64_t>(1) << b;
+                            const size_t shop = w * 64 + b;
+                            context each(*this, t, shop);
+
+                            bits &= bits - 1;
+                            compute(each, values[shop], (has_message[w] & bit) != 0 ? &inbox[shop] : nullptr);
+
+                            if (each.halted) {
+                                active[w] &= ~bit;
+                            } else {
+                                active[w] |= bit;
+                            }
+                        }
+
+                        has_message[w] = 0;
+                    }
+
+                    computed.arrive_and_wait();
+
+                    for (unsigned sender = 0; sender < workers; ++sender) {
+                        auto &buffer = outgoing[sender * workers + t];
+
+                        for (auto &message : buffer) {
+                            deliver(message.first, message.second);
+                        }
+
+                        buffer.clear();
+                    }
+
+                    pending[t] = 0;
+
+                    for (size_t w = first; w < last; ++w) {
+                        if ((active[w] | next_has_message[w]) != 0) {
+                            pending[t] = 1;
+                            break;
+                        }
+                    }
+
+                    merged.arrive_and_wait();
+                }
+            };
+
+            std::vector<std::thread> pool;
+
+            if (workers > 1) {
+                pool.reserve(workers - 1);
+            }
+
+            for (unsigned t = 1; t < workers; ++t) {
+                pool.emplace_back(step, t);
+            }
+
+            step(0u);
+
+            for (auto &worker : pool) {
+                worker.join();
+            }
+
+            return status::ok;
+        }
+    };
+
+    /**
+     bfs_levels()
+     Number of roads from the source to every shop, UINT64_MAX for the shops
+     it can't reach, one superstep per level.
+
+     @param levels Level by shop, replaced.
+     @return The status of the run.
+     */
+    template <graph_backend Graph>
+    inline status bfs_levels(const Graph &graph, const size_t source, std::vector<uint64_t> &levels, const unsigned threads = std::thread::hardware_concurrency()) {
+        bsp_engine<Graph, uint64_t> engine(graph, min_combiner(), threads);
+
+        levels.assign(graph.number_of_shops(), UINT64_MAX);
+
+        return engine.run(levels, [source] (auto &context, uint64_t &level, const uint64_t *message) {
+            if (context.superstep() == 0 && context.vertex() == source) {
+                level = 0;
+                context.send_to_neighbors(1);
+            } else if (message != nullptr && *message < level) {
+                level = *message;
+                context.send_to_neighbors(level + 1);
+            }
+
+            context.vote_to_halt();
+        });
+    }
+
+    /**
+     connected_components()
+     Labels every shop with the smallest index of its component. Each shop
+     starts with its own index, and sends on a smaller label when it gets
+     one; the engine stops once no label changes.
+
+     @param labels Component by shop, replaced.
+     @param components Number of components.
+     @return The status of the run.
+     */
+    template <graph_backend Graph>
+    inline status connected_components(const Graph &graph, std::vector<uint32_t> &labels, size_t &components, const unsigned threads = std::thread::hardware_concurrency()) {
+        bsp_engine<Graph, uint32_t> engine(graph, min_combiner(), threads);
+        const status result = engine.run(labels, [] (auto &context, uint32_t &label, const uint32_t *message) {
+            if (context.superstep() == 0) {
+                label = static_cast<uint32_t>(context.vertex());
+                context.send_to_neighbors(label);
+            } else if (message != nullptr && *message < label) {
+                label = *message;
+                context.send_to_neighbors(label);
+            }
+
+            context.vote_to_halt();
+        });
+
+        components = 0;
+
+        for (size_t i = 0; i < labels.size(); ++i) {
+            components += labels[i] == i ? 1 : 0;
+        }
+
+        return result;
+    }
+}
+
+#endif
@@ -0,0 +1,37 @@
+#ifndef THOMAS_CONFIG_HPP
+#define THOMAS_CONFIG_HPP
+
+#include <cstddef>
+#include <iostream>
+
+//  Neighbors the gather loops prefetch ahead, 0 disables prefetching
+#ifndef THOMAS_PREFETCH_DISTANCE
+#define THOMAS_PREFETCH_DISTANCE 8
+#endif
+
+//  Bytes of shop state a partition of edge_stream covers, about a private L2
+#ifndef THOMAS_STREAM_PARTITION_BYTES
+#define THOMAS_STREAM_PARTITION_BYTES (256 * 1024)
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define THOMAS_PREFETCH(address) __builtin_prefetch((address), 0, 3)
+#else
+#define THOMAS_PREFETCH(address) ((void) (address))
+#endif
+
+namespace thomas {
+#ifdef THOMAS_ENABLE_DEBUG
+    inline constexpr bool debug_output = true;
+#else
+    inline constexpr bool debug_output = false;
+#endif
+
+    inline constexpr size_t prefetch_distance = THOMAS_PREFETCH_DISTANCE;
+    inline constexpr size_t stream_partition_bytes = THOMAS_STREAM_PARTITION_BYTES;
+}
+
+//  Debugging output, the statement is discarded along with its operands unless enabled
+#define THOMAS_DEBUG_STREAM if constexpr (!thomas::debug_output) {} else std::cout
+
+#endif
@@ -0,0 +1,216 @@
+#ifndef THOMAS_CSR_NETWORK_HPP
+#define THOMAS_CSR_NETWORK_HPP
+
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <vector>
+
+#include "thomas/config.hpp"
+#include "thomas/edge_list.hpp"
+#include "thomas/network.hpp"
+
+namespace thomas {
+    /**
+     csr_network
+     Compressed rows of the connections of a network, with the widths of the
+     identifiers and of the indices as parameters. Connections are kept in
+     the order of the connection lists, parallel roads repeated, so degrees
+     match thomas::network. With 32 bit indices a connection takes a quarter
+     of the pointer it replaces, and a degree is the difference of two
+     neighboring offsets.
+     */
+    template <std::unsigned_integral Identifier = uint64_t, std::unsigned_integral Index = uint32_t>
+    class csr_network {
+    private:
+        std::vector<Index> offsets = { 0 };
+        std::vector<Index> targets;
+        std::vector<Identifier> identifiers;
+
+    public:
+        using identifier_type = Identifier;
+        using index_type = Index;
+
+        /**
+         fits()
+         Whether the network can be represented with these widths: the offsets
+         count connections, so they bound both the shops and the roads.
+
+         @return Whether assign() would succeed.
+         */
+        static inline bool fits(const network &network) noexcept {
+            if (network.number_of_connections() > std::numeric_limits<Index>::max()) {
+                return false;
+            }
+
+            for (size_t i = 0; i < network.number_of_shops(); ++i) {
+                if (network.identifier_at(i) > std::numeric_limits<Identifier>::max()) {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        static inline bool fits(const edge_list &edges) noexcept {
+            return 2 * static_cast<uint64_t>(edges.number_of_roads()) <= std::numeric_limits<Index>::max()
+                && edges.largest_identifier() <= std::numeric_limits<Identifier>::max();
+        }
+
+        /**
+         assign()
+         Builds the rows from a list of roads with a counting sort by shop.
+         Each road is appended to the row of its destination and then to the
+         row of its source, as network::connect() does.
+
+         @return Whether the roads fit into the widths.
+         */
+        inline bool assign(const edge_list &edges) {
+            if (!fits(edges)) {
+                return false;
+            }
+
+            const size_t count = edges.number_of_shops();
+            const size_t roads = edges.number_of_roads();
+            const uint64_t *endpoints = edges.data();
+
+            offsets.assign(count + 1, 0);
+            targets.resize(2 * roads);
+            identifiers.resize(count);
+
+            for (size_t r = 0; r < 2 * roads; ++r) {
+                ++offsets[static_cast<size_t>(endpoints[r]) + 1];
+            }
+
+            for (size_t i = 0; i < count; ++i) {
+                offsets[i + 1] += offsets[i];
+                identifiers[i] = static_cast<Identifier>(edges.identifier_at(i));
+            }
+
+            //  Rows are filled from their start, then shifted back in place
+            for (size_t r = 0; r < roads; ++r) {
+                const size_t source = static_cast<size_t>(endpoints[2 * r]);
+                const size_t destination = static_cast<size_t>(endpoints[2 * r + 1]);
+
+                targets[offsets[destination]++] = static_cast<Index>(source);
+                targets[offsets[source]++] = static_cast<Index>(destination);
+            }
+
+            for (size_t i = count; i > 0; --i) {
+                offsets[i] = offsets[i - 1];
+            }
+
+            offsets[0] = 0;
+
+            return true;
+        }
+
+        /**
+         assign()
+         Builds the rows from the connections of the network.
+
+         @return Whether the network fits into the widths.
+         */
+        inline bool assign(const network &network) {
+            if (!fits(network)) {
+                return false;
+            }
+
+            const size_t count = network.number_of_shops();
+
+            offsets.resize(count + 1);
+            targets.resize(static_cast<size_t>(network.number_of_connections()));
+            identifiers.resize(count);
+            offsets[0] = 0;
+
+            Index position = 0;
+
+            for (size_t i = 0; i < count; ++i) {
+                for (auto each : network.neighbors(i)) {
+                    targets[position++] = static_cast<Index>(each);
+                }
+
+                offsets[i + 1] = position;
+                identifiers[i] = static_cast<Identifier>(network.identifier_at(i));
+            }
+
+            return true;
+        }
+
+        inline size_t number_of_shops() const noexcept {
+            return identifiers.size();
+        }
+
+        inline Identifier identifier_at(const size_t i) const noexcept {
+            return identifiers[i];
+        }
+
+        inline Index degree(const size_t i) const noexcept {
+            return offsets[i + 1] - offsets[i];
+        }
+
+        inline std::span<const Index> neighbors(const size_t i) const noexcept {
+            return std::span<const Index>(targets.data() + offsets[i], degree(i));
+        }
+
+        /**
+         external_impact()
+         Gather of the generic algorithms, with the offsets of the neighbors
+         prefetched ahead as in network::external_impact().
+         */
+        inline uint64_t external_impact(const size_t i, const uint64_t threshold) const noexcept {
+            const Index *row = targets.data() + offsets[i];
+            const size_t count = degree(i);
+            const size_t ahead = count > prefetch_distance ? count - prefetch_distance : 0;
+            uint64_t impact = 0;
+            size_t k = 0;
+
+            for (; k < ahead; ++k) {
+                THOMAS_PREFETCH(offsets.data() + row[k + prefetch_distance]);
+
+                const uint64_t each = degree(row[k]);
+                impact += each < threshold ? each : 0;
+            }
+
+            for (; k < count; ++k) {
+                const uint64_t each = degree(row[k]);
+                impact += each < threshold ? each : 0;
+            }
+
+            return impact;
+        }
+    };
+
+    /**
+     visit_narrowest()
+     Compresses the roads into the narrowest csr_network they fit into, 32 bit
+     identifiers and indices for most inputs, and calls the function with it.
+
+     @return The value returned by the function.
+     */
+    template <typename Function>
+    inline decltype(auto) visit_narrowest(const edge_list &edges, Function &&function) {
+        if (csr_network<uint32_t, uint32_t>::fits(edges)) {
+            csr_network<uint32_t, uint32_t> narrow;
+            narrow.assign(edges);
+
+            return function(narrow);
+        }
+
+        if (csr_network<uint64_t, uint32_t>::fits(edges)) {
+            csr_network<uint64_t, uint32_t> wide_identifiers;
+            wide_identifiers.assign(edges);
+
+            return function(wide_identifiers);
+        }
+
+        csr_network<uint64_t, uint64_t> wide;
+        wide.assign(edges);
+
+        return function(wide);
+    }
+}
+
+#endif
@@ -0,0 +1,179 @@
+#ifndef THOMAS_DENSE_NETWORK_HPP
+#define THOMAS_DENSE_NETWORK_HPP
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "thomas/neighbors.hpp"
+#include "thomas/shop.hpp"
+
+namespace thomas {
+    /**
+     dense_network
+     Adjacency matrix of 64 bit words over the dense shop indices. Degrees are
+     row popcounts, and the neighbors outside a set of shops are a word-wise
+     AND NOT of the row with the set, so reduce() has no data dependent
+     branches on membership. Only simple networks can be represented, as a
+     bit can't count parallel roads.
+     */
+    class dense_network {
+    private:
+        size_t num_shops = 0;
+        size_t words = 0;
+
+        //  Row-major matrix, each row padded to whole words
+        std::vector<uint64_t> matrix;
+        std::vector<uint32_t> degrees;
+        std::vector<uint64_t> identifiers;
+
+        //  Temporaries of reduce(), kept for the next call
+        std::vector<uint64_t> tied;
+        std::vector<uint64_t> external;
+        std::vector<uint64_t> impacts;
+
+    public:
+        //  Upper bound of shops, the matrix takes 2 MiB at 4096 shops
+        static constexpr size_t max_shops = 4096;
+
+        /**
+         is_preferred()
+         Whether a network of the given size is cheaper to reduce as a matrix: a
+         row takes num_shops / 8 bytes, against 8 bytes per connection in a list.
+
+         @return Whether the matrix should be used.
+         */
+        static inline bool is_preferred(const size_t num_shops, const uint64_t connections) noexcept {
+            return num_shops != 0 && num_shops <= max_shops && connections * 64 >= static_cast<uint64_t>(num_shops) * num_shops;
+        }
+
+        /**
+         assign()
+         Builds the matrix from the connections of the shops, indexed with their
+         position in the given vector.
+
+         @return Whether the network is simple, i.e. without parallel roads or loops.
+         */
+        inline bool assign(const std::vector<shop *> &shops) {
+            num_shops = shops.size();
+            words = (num_shops + 63) / 64;
+            matrix.assign(num_shops * words, 0);
+            degrees.assign(num_shops, 0);
+            identifiers.resize(num_shops);
+
+            for (size_t i = 0; i < num_shops; ++i) {
+                uint64_t *row = matrix.data() + i * words;
+
+                for (auto &each_connection : shops[i]->get_connected_shops()) {
+                    const size_t j = each_connection->get_index();
+                    const uint64_t bit = uint64_t(1) << (j % 64);
+
+                    if (j == i || (row[j / 64] & bit) != 0) {
+                        return false;
+                    }
+
+                    row[j / 64] |= bit;
+                }
+
+                degrees[i] = static_cast<uint32_t>(shops[i]->get_connected_shops().size());
+                identifiers[i] = shops[i]->get_identifier();
+            }
+
+            return true;
+        }
+
+        inline size_t capacity_bytes() const noexcept {
+            return (matrix.capacity() + identifiers.capacity() + tied.capacity() + external.capacity() + impacts.capacity()) * sizeof(uint64_t)
+                 + degrees.capacity() * sizeof(uint32_t);
+        }
+
+        inline size_t number_of_shops() const noexcept {
+            return num_shops;
+        }
+
+        inline const uint64_t *row(const size_t i) const noexcept {
+            return matrix.data() + i * words;
+        }
+
+        inline uint64_t identifier_at(const size_t i) const noexcept {
+            return identifiers[i];
+        }
+
+        inline size_t degree(const size_t i) const noexcept {
+            return degrees[i];
+        }
+
+        inline bitset_neighbors neighbors(const size_t i) const noexcept {
+            return bitset_neighbors(row(i), words);
+        }
+
+        inline uint32_t degree_at(const size_t i) const noexcept {
+            return degrees[i];
+        }
+
+        inline bool has_edge(const size_t a, const size_t b) const noexcept {
+            return (row(a)[b / 64] >> (b % 64)) & 1;
+        }
+
+        /**
+         reduce()
+         Same reduction as network::reduce(), over the matrix.
+
+         @return The number of nodes disposed.
+         */
+        inline uint64_t reduce() {
+            if (num_shops == 0) {
+                return 0;
+            }
+
+            uint32_t threshold = 0;
+
+            for (size_t i = 0; i < num_shops; ++i) {
+                threshold = degrees[i] > threshold ? degrees[i] : threshold;
+            }
+
+            tied.assign(words, 0);
+            external.resize(words);
+            impacts.clear();
+
+            for (size_t i = 0; i < num_shops; ++i) {
+                tied[i / 64] |= uint64_t(degrees[i] == threshold) << (i % 64);
+            }
+
+            uint64_t required_impact = 0;
+
+            for (size_t w = 0; w < words; ++w) {
+                for (uint64_t bits = tied[w]; bits != 0; bits &= bits - 1) {
+                    const uint64_t *neighbors = row(w * 64 + static_cast<size_t>(std::countr_zero(bits)));
+                    uint64_t impact = 0;
+
+                    //  Neighbors outside of the tie set
+                    for (size_t k = 0; k < words; ++k) {
+                        external[k] = neighbors[k] & ~tied[k];
+                    }
+
+                    for (size_t k = 0; k < words; ++k) {
+                        for (uint64_t each = external[k]; each != 0; each &= each - 1) {
+                            impact += degrees[k * 64 + static_cast<size_t>(std::countr_zero(each))];
+                        }
+                    }
+
+                    impacts.push_back(impact);
+                    required_impact = impact > required_impact ? impact : required_impact;
+                }
+            }
+
+            uint64_t count = 0;
+
+            for (auto &impact : impacts) {
+                count += impact == required_impact;
+            }
+
+            //  If the number of elements remaining is lower than two, no further action is required
+            return count < 2 ? 0 : count;
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,83 @@
+#ifndef THOMAS_EDGE_LIST_HPP
+#define THOMAS_EDGE_LIST_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "thomas/identifier_map.hpp"
+
+namespace thomas {
+    /**
+     edge_list
+     Roads as pairs of dense shop indices, in the order they were read. Shops
+     are registered on first sight as thomas::network does, so indices agree
+     with a network loaded from the same input, but there is no per shop
+     storage until the roads are compressed into rows, see csr_network.
+     */
+    class edge_list {
+    private:
+        identifier_map identifiers;
+        std::vector<uint64_t> shop_identifiers;
+        std::vector<uint64_t> endpoints;
+
+        uint64_t max_identifier = 0;
+
+    public:
+        inline void reserve(const uint64_t num_shops, const uint64_t num_roads, const uint64_t max_identifier = 0) {
+            shop_identifiers.reserve(static_cast<size_t>(num_shops));
+            endpoints.reserve(static_cast<size_t>(2 * num_roads));
+            identifiers.reserve(static_cast<size_t>(num_shops), max_identifier);
+        }
+
+        inline size_t number_of_shops() const noexcept {
+            return shop_identifiers.size();
+        }
+
+        inline size_t number_of_roads() const noexcept {
+            return endpoints.size() / 2;
+        }
+
+        inline uint64_t identifier_at(const size_t i) const noexcept {
+            return shop_identifiers[i];
+        }
+
+        inline uint64_t largest_identifier() const noexcept {
+            return max_identifier;
+        }
+
+        //  Endpoint indices, two per road
+        inline const uint64_t *data() const noexcept {
+            return endpoints.data();
+        }
+
+        /**
+         find_or_register()
+         Looks up the index of the shop with the given identifier, registering
+         it when missing.
+
+         @return The index of the shop.
+         */
+        inline size_t find_or_register(const uint64_t identifier) {
+            const size_t index = identifiers.insert(identifier, shop_identifiers.size());
+
+            if (index == shop_identifiers.size()) {
+                shop_identifiers.push_back(identifier);
+                max_identifier = std::max(max_identifier, identifier);
+            }
+
+            return index;
+        }
+
+        inline void connect(const uint64_t from, const uint64_t to) {
+            const size_t source = find_or_register(from);
+            const size_t destination = find_or_register(to);
+
+            endpoints.push_back(source);
+            endpoints.push_back(destination);
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,361 @@
+#ifndef THOMAS_EDGE_STREAM_HPP
+#define THOMAS_EDGE_STREAM_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "thomas/config.hpp"
+#include "thomas/edge_list.hpp"
+#include "thomas/graph_backend.hpp"
+#include "thomas/radix_sort.hpp"
+#include "thomas/reduce_result.hpp"
+
+namespace thomas {
+    /**
+     edge_stream
+     Edge centric layout of a network. Shops are split into partitions of
+     consecutive indices, as many as their state fits into a cache, and every
+     road is kept as two directed edges in the partition of its source.
+
+     An algorithm runs as rounds of scatter_gather(): the edges of each
+     partition are streamed in order, producing updates for their targets
+     from the state of their sources, which is the partition in cache. The
+     updates are shuffled by the partition of their target, and gathered one
+     partition at a time, so shop state is never accessed at random across
+     the whole network. Shops are indexed with 32 bits.
+     */
+    class edge_stream {
+    private:
+        size_t state_bytes;
+        size_t shift = 0;
+        uint64_t num_edges = 0;
+
+        std::vector<uint64_t> identifiers;
+
+        //  Edges as pack_edge(source, target), by partition of the source
+        std::vector<std::vector<uint64_t>> partitions;
+
+        inline void split(const size_t count) {
+            const size_t shops = std::max<size_t>(stream_partition_bytes / state_bytes, 1);
+
+            //  Partitions are a power of two in size, a shift finds them
+            shift = 0;
+
+            while ((static_cast<size_t>(2) << shift) <= shops) {
+                ++shift;
+            }
+
+            partitions.assign(count == 0 ? 0 : ((count - 1) >> shift) + 1, {});
+        }
+
+    public:
+        /**
+         edge_stream()
+
+         @param state_bytes Bytes of state per shop the partitions are sized for.
+         */
+        explicit edge_stream(const size_t state_bytes = sizeof(uint64_t)) : state_bytes(std::max<size_t>(state_bytes, 1)) {
+            //  Empty implementation
+        }
+
+        /**
+         assign()
+         Splits the roads into edges in both directions, with a first pass
+         counting the edges of every partition.
+
+         @return Whether the shops fit into 32 bit indices.
+         */
+        inline bool assign(const edge_list &edges) {
+            const size_t count = edges.number_of_shops();
+            const size_t roads = edges.number_of_roads();
+            const uint64_t *endpoints = edges.data();
+
+            if (count > UINT32_MAX) {
+                return false;
+            }
+
+            split(count);
+            identifiers.resize(count);
+
+            for (size_t i = 0; i < count; ++i) {
+                identifiers[i] = edges.identifier_at(i);
+            }
+
+            std::vector<size_t> sizes(partitions.size(), 0);
+
+            for (size_t r = 0; r < 2 * roads; ++r) {
+                ++sizes[static_cast<size_t>(endpoints[r]) >> shift];
+            }
+
+            for (size_t p = 0; p < partitions.size(); ++p) {
+                partitions[p].reserve(sizes[p]);
+            }
+
+            for (size_t r = 0; r < roads; ++r) {
+                const uint32_t source = static_cast<uint32_t>(endpoints[2 * r]);
+                const uint32_t destination = static_cast<uint32_t>(endpoints[2 * r + 1]);
+
+                partitions[source >> shift].push_back(pack_edge(source, destination));
+                partitions[destination >> shift].push_back(pack_edge(destination, source));
+            }
+
+            num_edges = 2 * static_cast<uint64_t>(roads);
+
+            return true;
+        }
+
+        /**
+         assign()
+         Takes the connections of any backend as edges from the shop to each of
+         its neighbors.
+
+         @return Whether the shops fit into 32 bit indices.
+         */
+        template <graph_backend Graph>
+        inline bool assign(const Graph &graph) {
+            const size_t count = graph.number_of_shops();
+
+            if (count > UINT32_MAX) {
+                return false;
+            }
+
+            split(count);
+            identifiers.resize(count);
+            num_edges = 0;
+
+            for (size_t i = 0; i < count; ++i) {
+                std::vector<uint64_t> &partition = partitions[i >> shift];
+
+                identifiers[i] = graph.identifier_at(i);
+
+                for (auto each : graph.neighbors(i)) {
+                    partition.push_back(pack_edge(static_cast<uint32_t>(i), static_cast<uint32_t>(each)));
+                }
+
+                num_edges += graph.degree(i);
+            }
+
+            return true;
+        }
+
+        inline size_t number_of_shops() const noexcept {
+            return identifiers.size();
+        }
+
+        inline uint64_t number_of_edges() const noexcept {
+            return num_edges;
+        }
+
+        inline size_t number_of_partitions() const noexcept {
+            return partitions.size();
+        }
+
+        inline uint64_t identifier_at(const size_t i) const noexcept {
+            return identifiers[i];
+        }
+
+        /**
+         scatter_gather()
+         One round over every edge. The scatter function is called with the
+         source and target of each edge and an update to fill, and returns
+         whether the update is sent. The gather function is then called with
+         the target and the update, by partition of the target, in the order
+         the updates were scattered.
+
+         Each thread streams its own partitions into buffers of its own, one
+         per target partition. A partition is gathered by a single thread, so
+         gather may write the state of its target without synchronization.
+         Scatter should only read state, it runs before any gather.
+
+         @param scatter Function of (source, target, Value &) returning bool.
+         @param gather Function of (target, const Value &).
+         @param threads Number of threads to use.
+         */
+        template <typename Value, typename Scatter, typename Gather>
+        inline void scatter_gather(Scatter &&scatter, Gather &&gather, unsigned threads = std::thread::hardware_concurrency()) const {
+            using update = std::pair<uint32_t, Value>;
+
+            const size_t count = partitions.size();
+
+            if (count == 0) {
+                return;
+            }
+
+            //  Small inputs don't pay for the threads
+            threads = num_edges < 65536 ? 1u : std::clamp<unsigned>(threads, 1u, static_cast<unsigned>(std::min<size_t>(count, UINT32_MAX)));
+
+            //  Update buffers, thread major, by partition of the target
+            std::vector<std::vector<update>> buffers(threads * count);
+
+            const auto run = [&] (auto &&step) {
+                std::vector<std::thread> workers;
+
+                if (threads > 1) {
+                    workers.reserve(threads - 1);
+                }
+
+                for (unsigned t = 1; t < threads; ++t) {
+                    workers.emplace_back(step, t);
+                }
+
+                step(0u);
+
+                for (auto &worker : workers) {
+                    worker.join();
+                }
+            };
+
+            run([&] (const unsigned t) {
+                std::vector<update> *outgoing = buffers.data() + t * count;
+                Value value{};
+                size_t streamed = 0;
+
+                //  Room for evenly spread updates, growing past it is the exception
+                for (size_t p = t; p < count; p += threads) {
+                    streamed += partitions[p].size();
+                }
+
+                for (size_t p = 0; p < count; ++p) {
+                    outgoing[p].reserve(streamed / count);
+                }
+
+                for (size_t p = t; p < count; p += threads) {
+                    for (auto &edge : partitions[p]) {
+                        const uint32_t target = edge_target(edge);
+
+                        if (scatter(edge_source(edge), target, value)) {
+                            outgoing[target >> shift].emplace_back(target, value);
+                        }
+                    }
+                }
+            });
+
+            run([&] (const unsigned t) {
+                for (size_t p = t; p < count; p += threads) {
+                    for (unsigned source = 0; source < threads; ++source) {
+                        for (auto &each : buffers[source * count + p]) {
+                            gather(each.first, each.second);
+                        }
+                    }
+                }
+            });
+        }
+    };
+
+    /**
+     count_degrees()
+     Degrees as a scatter of one update per edge, parallel roads and both
+     ends of a loop counted, as network::reduce() does.
+     */
+    inline void count_degrees(const edge_stream &stream, std::vector<uint64_t> &degrees, unsigned threads = std::thread::hardware_concurrency()) {
+        degrees.assign(stream.number_of_shops(), 0);
+
+        stream.scatter_gather<uint32_t>([] (uint32_t, uint32_t, uint32_t &value) {
+            value = 1;
+            return true;
+        }, [&] (const uint32_t target, const uint32_t value) {
+            degrees[target] += value;
+        }, threads);
+    }
+
+    /**
+     analyze()
+     Reduction of network::reduce() over an edge_stream, in two rounds: the
+     degrees, then the impacts, where every edge from a shop below the
+     threshold sends its degree and only shops at the threshold keep it.
+
+     @param impacts Impact by shop, replaced.
+     @param disposed Storage of the shops of the result, replaced.
+     @return The result of the reduction.
+     */
+    inline reduce_result analyze(const edge_stream &stream, std::vector<uint64_t> &impacts, std::vector<size_t> &disposed, unsigned threads = std::thread::hardware_concurrency()) {
+        const size_t count = stream.number_of_shops();
+        std::vector<uint64_t> degrees;
+        reduce_result result;
+
+        count_degrees(stream, degrees, threads);
+        impacts.assign(count, 0);
+        disposed.clear();
+
+        for (auto &degree : degrees) {
+            result.threshold = std::max(result.threshold, degree);
+        }
+
+        const uint64_t threshold = result.threshold;
+
+        stream.scatter_gather<uint64_t>([&] (const uint32_t source, uint32_t, uint64_t &value) {
+            value = degrees[source];
+            return value < threshold;
+        }, [&] (const uint32_t target, const uint64_t value) {
+            impacts[target] += degrees[target] == threshold ? value : 0;
+        }, threads);
+
+        for (size_t i = 0; i < count; ++i) {
+            if (degrees[i] == threshold) {
+                result.required_impact = std::max(result.required_impact, impacts[i]);
+            }
+        }
+
+        for (size_t i = 0; i < count; ++i) {
+            if (degrees[i] == threshold && impacts[i] == result.required_impact) {
+                disposed.push_back(i);
+            }
+        }
+
+        result.count = disposed.size();
+        result.shops = std::span<const size_t>(disposed.data(), disposed.size());
+
+        return result;
+    }
+
+    /**
+     connected_components()
+     Labels every shop with the smallest index of its component, by rounds
+     of label propagation. Only shops whose label changed in the previous
+     round send it along their edges, the rounds end when none did.
+
+     @param labels Component by shop, replaced.
+     @return The number of components.
+     */
+    inline size_t connected_components(const edge_stream &stream, std::vector<uint32_t> &labels, unsigned threads = std::thread::hardware_concurrency()) {
+        const size_t count = stream.number_of_shops();
+        std::vector<uint8_t> changed(count, 1), next(count, 0);
+
+        labels.resize(count);
+
+        for (size_t i = 0; i < count; ++i) {
+            labels[i] = static_cast<uint32_t>(i);
+        }
+
+        for (bool active = count != 0; active;) {
+            stream.scatter_gather<uint32_t>([&] (const uint32_t source, uint32_t, uint32_t &value) {
+                value = labels[source];
+                return changed[source] != 0;
+            }, [&] (const uint32_t target, const uint32_t value) {
+                if (value < labels[target]) {
+                    labels[target] = value;
+                    next[target] = 1;
+                }
+            }, threads);
+
+            active = std::find(next.begin(), next.end(), 1) != next.end();
+            changed.swap(next);
+            std::fill(next.begin(), next.end(), 0);
+        }
+
+        size_t components = 0;
+
+        for (size_t i = 0; i < count; ++i) {
+            components += labels[i] == i ? 1 : 0;
+        }
+
+        return components;
+    }
+}
+
+#endif
@@ -0,0 +1,123 @@
+#ifndef THOMAS_GRAPH_BACKEND_HPP
+#define THOMAS_GRAPH_BACKEND_HPP
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <ranges>
+#include <span>
+#include <vector>
+
+#include "thomas/reduce_result.hpp"
+
+namespace thomas {
+    /**
+     graph_backend
+     Storage layout the algorithms below run on. Shops are the dense indices
+     below number_of_shops(), neighbors() lists the indices connected to a
+     shop with parallel roads repeated, so that its size is degree(), and
+     identifier_at() maps an index back to the identifier of the shop.
+     */
+    template <typename Graph>
+    concept graph_backend = requires (const Graph &graph, const size_t i) {
+        { graph.number_of_shops() } -> std::convertible_to<size_t>;
+        { graph.degree(i) } -> std::convertible_to<uint64_t>;
+        { graph.identifier_at(i) } -> std::convertible_to<uint64_t>;
+        { graph.neighbors(i) } -> std::ranges::forward_range;
+        requires std::convertible_to<std::ranges::range_value_t<decltype(graph.neighbors(i))>, size_t>;
+    };
+
+    /**
+     external_impact()
+     Sums the degrees of the neighbors below the threshold. Backends with a
+     faster gather of their own provide it as a member of the same name.
+
+     @return The external impact of the shop.
+     */
+    template <graph_backend Graph>
+    inline uint64_t external_impact(const Graph &graph, const size_t i, const uint64_t threshold) noexcept {
+        if constexpr (requires { { graph.external_impact(i, threshold) } -> std::convertible_to<uint64_t>; }) {
+            return graph.external_impact(i, threshold);
+        } else {
+            uint64_t impact = 0;
+
+            for (auto each : graph.neighbors(i)) {
+                const uint64_t degree = graph.degree(static_cast<size_t>(each));
+                impact += degree < threshold ? degree : 0;
+            }
+
+            return impact;
+        }
+    }
+
+    template <graph_backend Graph>
+    inline uint64_t count_connections(const Graph &graph) noexcept {
+        uint64_t counter = 0;
+
+        for (size_t i = 0; i < graph.number_of_shops(); ++i) {
+            counter += graph.degree(i);
+        }
+
+        return counter;
+    }
+
+    /**
+     analyze()
+     Reduction of network::reduce() over any backend, keeping the shops tied
+     at the required impact in the given storage.
+
+     @param impacts Impact by shop, replaced.
+     @param disposed Storage of the shops of the result, replaced.
+     @return The result of the reduction.
+     */
+    template <graph_backend Graph>
+    inline reduce_result analyze(const Graph &graph, std::vector<uint64_t> &impacts, std::vector<size_t> &disposed) {
+        const size_t count = graph.number_of_shops();
+        reduce_result result;
+
+        impacts.clear();
+        disposed.clear();
+
+        for (size_t i = 0; i < count; ++i) {
+            result.threshold = std::max<uint64_t>(result.threshold, graph.degree(i));
+        }
+
+        //  Shops with the highest degree are exactly the ones at the threshold
+        for (size_t i = 0; i < count; ++i) {
+            uint64_t impact = 0;
+
+            if (graph.degree(i) == result.threshold) {
+                impact = external_impact(graph, i, result.threshold);
+                result.required_impact = std::max(result.required_impact, impact);
+            }
+
+            impacts.push_back(impact);
+        }
+
+        for (size_t i = 0; i < count; ++i) {
+            if (graph.degree(i) == result.threshold && impacts[i] == result.required_impact) {
+                disposed.push_back(i);
+            }
+        }
+
+        result.count = disposed.size();
+        result.shops = std::span<const size_t>(disposed.data(), disposed.size());
+
+        return result;
+    }
+
+    template <graph_backend Graph>
+    inline std::ostream &print(std::ostream &os, const Graph &graph) {
+        for (size_t i = 0; i < graph.number_of_shops(); ++i) {
+            for (auto remote : graph.neighbors(i)) {
+                os << graph.identifier_at(i) << " is connected with " << graph.identifier_at(static_cast<size_t>(remote)) << std::endl;
+            }
+        }
+
+        return os;
+    }
+}
+
+#endif
@@ -0,0 +1,222 @@
+#ifndef THOMAS_GRAPH_BATCH_HPP
+#define THOMAS_GRAPH_BATCH_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "thomas/network.hpp"
+
+namespace thomas {
+    /**
+     graph_batch
+     Many small networks packed into shared flat buffers. Graph g has
+     shop_counts[g] shops with local dense indices, and its roads are the
+     endpoint pairs in between road_offsets[g] and road_offsets[g + 1].
+     */
+    class graph_batch {
+    private:
+        std::vector<uint64_t> road_offsets = { 0 };
+        std::vector<uint32_t> shop_counts;
+        std::vector<uint32_t> endpoints;
+
+    public:
+        inline void reserve(const size_t graphs, const size_t roads) {
+            road_offsets.reserve(graphs + 1);
+            shop_counts.reserve(graphs);
+            endpoints.reserve(2 * roads);
+        }
+
+        inline void clear() noexcept {
+            road_offsets.assign(1, 0);
+            shop_counts.clear();
+            endpoints.clear();
+        }
+
+        inline size_t size() const noexcept {
+            return shop_counts.size();
+        }
+
+        inline uint32_t shops_of(const size_t graph) const noexcept {
+            return shop_counts[graph];
+        }
+
+        inline uint64_t roads_of(const size_t graph) const noexcept {
+            return road_offsets[graph + 1] - road_offsets[graph];
+        }
+
+        inline const uint32_t *endpoints_of(const size_t graph) const noexcept {
+            return endpoints.data() + 2 * road_offsets[graph];
+        }
+
+        /**
+         add_graph()
+         Appends a graph given as pairs of local shop indices below num_shops.
+         */
+        inline void add_graph(const uint32_t num_shops, const uint32_t *pairs, const size_t num_roads) {
+            endpoints.insert(endpoints.end(), pairs, pairs + 2 * num_roads);
+            shop_counts.push_back(num_shops);
+            road_offsets.push_back(road_offsets.back() + num_roads);
+        }
+
+        /**
+         add_network()
+         Appends a network, each road is taken once from its lower indexed end.
+         */
+        inline void add_network(network &network) {
+            uint64_t num_roads = 0;
+
+            for (auto &each_shop : network.get_shops()) {
+                const uint32_t i = static_cast<uint32_t>(each_shop->get_index());
+                uint64_t loops = 0;
+
+                for (auto &each_connection : each_shop->get_connected_shops()) {
+                    const uint32_t j = static_cast<uint32_t>(each_connection->get_index());
+
+                    if (i < j) {
+                        endpoints.push_back(i);
+                        endpoints.push_back(j);
+                        ++num_roads;
+                    } else if (i == j) {
+                        ++loops;
+                    }
+                }
+
+                //  A road to itself is listed twice in the connections
+                for (uint64_t k = 0; k < loops / 2; ++k) {
+                    endpoints.push_back(i);
+                    endpoints.push_back(i);
+                    ++num_roads;
+                }
+            }
+
+            shop_counts.push_back(static_cast<uint32_t>(network.number_of_shops()));
+            road_offsets.push_back(road_offsets.back() + num_roads);
+        }
+    };
+
+    /**
+     batch_scratch
+     Per thread temporaries of reduce_batch(), grown to the largest graph seen.
+     */
+    struct batch_scratch {
+        std::vector<uint32_t> degrees;
+        std::vector<uint32_t> tied;
+        std::vector<uint64_t> impacts;
+    };
+
+    /**
+     reduce_graph()
+     network::reduce() over one graph of a batch. Each pass is a flat loop
+     over arrays, the tie set test being arithmetic rather than a branch.
+
+     @return The number of nodes disposed.
+     */
+    inline uint64_t reduce_graph(const graph_batch &batch, const size_t graph, batch_scratch &scratch) {
+        const uint32_t num_shops = batch.shops_of(graph);
+        const uint64_t num_roads = batch.roads_of(graph);
+        const uint32_t *pairs = batch.endpoints_of(graph);
+
+        if (num_shops == 0) {
+            return 0;
+        }
+
+        if (scratch.degrees.size() < num_shops) {
+            scratch.degrees.resize(num_shops);
+            scratch.tied.resize(num_shops);
+            scratch.impacts.resize(num_shops);
+        }
+
+        uint32_t *degrees = scratch.degrees.data();
+        uint32_t *tied = scratch.tied.data();
+        uint64_t *impacts = scratch.impacts.data();
+
+        std::fill(degrees, degrees + num_shops, 0);
+        std::fill(impacts, impacts + num_shops, 0);
+
+        for (uint64_t i = 0; i < 2 * num_roads; ++i) {
+            degrees[pairs[i]] += 1;
+        }
+
+        uint32_t threshold = 0;
+
+        for (uint32_t i = 0; i < num_shops; ++i) {
+            threshold = std::max(threshold, degrees[i]);
+        }
+
+        for (uint32_t i = 0; i < num_shops; ++i) {
+            tied[i] = degrees[i] == threshold;
+        }
+
+        //  Only roads leaving the tie set contribute, loops never do
+        for (uint64_t i = 0; i < num_roads; ++i) {
+            const uint32_t a = pairs[2 * i];
+            const uint32_t b = pairs[2 * i + 1];
+
+            impacts[a] += static_cast<uint64_t>(tied[a] & (tied[b] ^ 1)) * degrees[b];
+            impacts[b] += static_cast<uint64_t>(tied[b] & (tied[a] ^ 1)) * degrees[a];
+        }
+
+        //  Impacts outside of the tie set stay zero
+        uint64_t required_impact = 0;
+
+        for (uint32_t i = 0; i < num_shops; ++i) {
+            required_impact = std::max(required_impact, impacts[i]);
+        }
+
+        uint64_t count = 0;
+
+        for (uint32_t i = 0; i < num_shops; ++i) {
+            count += tied[i] & (impacts[i] == required_impact);
+        }
+
+        //  If the number of elements remaining is lower than two, no further action is required
+        return count < 2 ? 0 : count;
+    }
+
+    /**
+     reduce_batch()
+     Reduces every graph of the batch, writing the results in graph order.
+     Graphs are handed out to the threads in chunks, and each thread reuses
+     its scratch, so no allocation happens per graph once it has grown.
+     */
+    inline void reduce_batch(const graph_batch &batch, uint64_t *results, unsigned threads = std::thread::hardware_concurrency()) {
+        static constexpr size_t chunk = 256;
+
+        const size_t graphs = batch.size();
+        const size_t chunks = (graphs + chunk - 1) / chunk;
+        std::atomic<size_t> next(0);
+
+        const auto work = [&] () {
+            batch_scratch scratch;
+
+            for (size_t c = next.fetch_add(1, std::memory_order_relaxed); c < chunks; c = next.fetch_add(1, std::memory_order_relaxed)) {
+                const size_t end = std::min(graphs, (c + 1) * chunk);
+
+                for (size_t g = c * chunk; g < end; ++g) {
+                    results[g] = reduce_graph(batch, g, scratch);
+                }
+            }
+        };
+
+        threads = std::max(1u, std::min<unsigned>(threads, static_cast<unsigned>(std::max<size_t>(chunks, 1))));
+
+        std::vector<std::thread> workers;
+        workers.reserve(threads - 1);
+
+        for (unsigned t = 1; t < threads; ++t) {
+            workers.emplace_back(work);
+        }
+
+        work();
+
+        for (auto &each_worker : workers) {
+            each_worker.join();
+        }
+    }
+}
+
+#endif
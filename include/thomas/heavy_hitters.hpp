@@ -0,0 +1,407 @@
+#ifndef THOMAS_HEAVY_HITTERS_HPP
+#define THOMAS_HEAVY_HITTERS_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "thomas/identifier_map.hpp"
+
+namespace thomas {
+    /**
+     space_saving
+     Top counts of a stream of identifiers in a fixed number of counters. A
+     missing identifier takes over the smallest counter, so counts are over
+     estimated by at most the count it took over, kept as the error. Every
+     identifier seen more than total / capacity times holds a counter.
+     */
+    class space_saving {
+    public:
+        struct counter {
+            uint64_t identifier;
+            uint64_t count;
+            uint64_t error;
+        };
+
+    private:
+        //  Min-heap on count, with the position of each identifier
+        std::vector<counter> heap;
+        std::unordered_map<uint64_t, size_t> positions;
+        size_t capacity;
+        uint64_t total = 0;
+
+        inline void sift_down(size_t i) noexcept {
+            for (;;) {
+                const size_t left = 2 * i + 1, right = left + 1;
+                size_t smallest = i;
+
+                if (left < heap.size() && heap[left].count < heap[smallest].count) {
+                    smallest = left;
+                }
+
+                if (right < heap.size() && heap[right].count < heap[smallest].count) {
+                    smallest = right;
+                }
+
+                if (smallest == i) {
+                    return;
+                }
+
+                std::swap(heap[i], heap[smallest]);
+                positions[heap[i].identifier] = i;
+                positions[heap[smallest].identifier] = smallest;
+                i = smallest;
+            }
+        }
+
+        inline void sift_up(size_t i) noexcept {
+            while (i > 0 && heap[(i - 1) / 2].count > heap[i].count) {
+                const size_t parent = (i - 1) / 2;
+
+                std::swap(heap[i], heap[parent]);
+                positions[heap[i].identifier] = i;
+                positions[heap[parent].identifier] = parent;
+                i = parent;
+            }
+        }
+
+    public:
+        explicit space_saving(const size_t capacity) : capacity(std::max<size_t>(capacity, 1)) {
+            heap.reserve(this->capacity);
+            positions.reserve(this->capacity);
+        }
+
+        inline void add(const uint64_t identifier) {
+            ++total;
+
+            auto position = positions.find(identifier);
+
+            if (position != positions.end()) {
+                ++heap[position->second].count;
+                sift_down(position->second);
+                return;
+            }
+
+            if (heap.size() < capacity) {
+                heap.push_back({ identifier, 1, 0 });
+                positions.emplace(identifier, heap.size() - 1);
+                sift_up(heap.size() - 1);
+                return;
+            }
+
+            //  Take over the smallest counter
+            positions.erase(heap[0].identifier);
+            heap[0] = { identifier, heap[0].count + 1, heap[0].count };
+            positions.emplace(identifier, 0);
+            sift_down(0);
+        }
+
+        inline const std::vector<counter> &get_counters() const noexcept {
+            return heap;
+        }
+
+        inline uint64_t get_total() const noexcept {
+            return total;
+        }
+
+        inline size_t get_capacity() const noexcept {
+            return capacity;
+        }
+    };
+
+    /**
+     count_min
+     Counts of a stream of identifiers in depth rows of width counters, each
+     row with its own hash. An estimate is the smallest of the counters of
+     the identifier, which over estimates by total * e / width at most with
+     probability 1 - e^-depth.
+     */
+    class count_min {
+    private:
+        std::vector<uint64_t> counters;
+        size_t width;
+        size_t depth;
+
+        inline size_t slot_of(const uint64_t identifier, const size_t row) const noexcept {
+            //  Multiply-shift with a distinct odd multiplier per row
+            const uint64_t multiplier = 0x9e3779b97f4a7c15ull + 2 * row * 0xbf58476d1ce4e5b9ull;
+
+            return row * width + static_cast<size_t>(((identifier ^ (identifier >> 31)) * multiplier >> 32) % width);
+        }
+
+    public:
+        count_min(const size_t width, const size_t depth = 4) : counters(std::max<size_t>(width, 1) * std::max<size_t>(depth, 1), 0), width(std::max<size_t>(width, 1)), depth(std::max<size_t>(depth, 1)) {
+            //  Empty implementation
+        }
+
+        inline void add(const uint64_t identifier) noexcept {
+            for (size_t row = 0; row < depth; ++row) {
+                ++counters[slot_of(identifier, row)];
+            }
+        }
+
+        inline uint64_t estimate(const uint64_t identifier) const noexcept {
+            uint64_t smallest = UINT64_MAX;
+
+            for (size_t row = 0; row < depth; ++row) {
+                smallest = std::min(smallest, counters[slot_of(identifier, row)]);
+            }
+
+            return smallest;
+        }
+    };
+
+    /**
+     approximate_result
+     Outcome of heavy_hitters, as reduce_result with the disposed shops as
+     identifiers. The answer is exact when it is guaranteed, i.e. when the
+     threshold is above what the sketch can miss, and the impacts were
+     verified.
+     */
+    struct approximate_result {
+        uint64_t threshold = 0;
+        uint64_t required_impact = 0;
+        uint64_t count = 0;
+        std::vector<uint64_t> shops;
+        bool guaranteed = false;
+
+        inline uint64_t disposed() const noexcept {
+            return count < 2 ? 0 : count;
+        }
+    };
+
+    /**
+     heavy_hitters
+     Approximate reduce() of a stream of roads too large to index. The roads
+     are replayed through connect() once per pass, as an importer would load
+     them into a network:
+
+     1. sketch: every endpoint is counted into a space_saving summary of the
+        top degrees, and a count_min sketch of every degree.
+     2. degrees: the exact degrees and the neighbors of the candidates of the
+        summary are collected, which gives the threshold and the tie set.
+     3. neighbors: the exact degrees of the neighbors of the tied shops are
+        counted, for the impacts. Skipped when impacts may be estimated, the
+        sketch then stands in for the neighbor degrees.
+
+     The summary and the sketch take memory bounded by the capacity and the
+     sketch width, independent of the number of shops. The neighbor lists of
+     the candidates don't: they hold the degree of each candidate, which for
+     the hubs this looks for is up to the number of roads, so the degrees pass
+     takes up to capacity * max degree identifiers. Only the lists of the tied
+     shops are kept past it.
+     */
+    class heavy_hitters {
+    public:
+        enum class pass {
+            sketch,
+            degrees,
+            neighbors,
+            done
+        };
+
+    private:
+        space_saving summary;
+        count_min sketch;
+        bool exact_impacts;
+        pass current = pass::sketch;
+
+        //  Candidates of the summary, by index
+        identifier_map candidates;
+        std::vector<uint64_t> candidate_identifiers;
+        std::vector<uint64_t> degrees;
+        std::vector<std::vector<uint64_t>> neighbors;
+
+        uint64_t threshold = 0;
+        std::vector<size_t> tied;
+
+        //  Neighbors of the tied shops, by index
+        identifier_map counted;
+        std::vector<uint64_t> counted_degrees;
+
+        inline void count_candidate(const uint64_t identifier, const uint64_t neighbor) {
+            const size_t index = candidates.find(identifier);
+
+            if (index != identifier_map::npos) {
+                ++degrees[index];
+                neighbors[index].push_back(neighbor);
+            }
+        }
+
+        inline void count_neighbor(const uint64_t identifier) noexcept {
+            const size_t index = counted.find(identifier);
+
+            if (index != identifier_map::npos) {
+                ++counted_degrees[index];
+            }
+        }
+
+        inline uint64_t degree_of(const uint64_t identifier) const noexcept {
+            size_t index = counted.find(identifier);
+
+            if (index != identifier_map::npos) {
+                return counted_degrees[index];
+            }
+
+            index = candidates.find(identifier);
+
+            if (index != identifier_map::npos) {
+                return degrees[index];
+            }
+
+            return sketch.estimate(identifier);
+        }
+
+    public:
+        /**
+         heavy_hitters()
+
+         @param capacity Number of candidates tracked for the threshold.
+         @param sketch_width Counters per row of the degree sketch.
+         @param exact_impacts Whether to verify the impacts with a third pass.
+         */
+        explicit heavy_hitters(const size_t capacity, const size_t sketch_width = 1 << 16, const bool exact_impacts = true)
+            : summary(capacity), sketch(sketch_width), exact_impacts(exact_impacts) {
+            //  Empty implementation
+        }
+
+        inline pass get_pass() const noexcept {
+            return current;
+        }
+
+        inline bool needs_pass() const noexcept {
+            return current != pass::done;
+        }
+
+        /**
+         next_pass()
+         Finishes the current pass and prepares the next one.
+         */
+        inline void next_pass() {
+            if (current == pass::sketch) {
+                const auto &counters = summary.get_counters();
+
+                candidates.reserve(counters.size());
+                candidate_identifiers.clear();
+
+                for (auto &each : counters) {
+                    candidates.insert(each.identifier, candidate_identifiers.size());
+                    candidate_identifiers.push_back(each.identifier);
+                }
+
+                degrees.assign(candidate_identifiers.size(), 0);
+                neighbors.assign(candidate_identifiers.size(), {});
+                current = pass::degrees;
+            } else if (current == pass::degrees) {
+                threshold = 0;
+                tied.clear();
+
+                for (auto &degree : degrees) {
+                    threshold = std::max(threshold, degree);
+                }
+
+                for (size_t i = 0; i < degrees.size(); ++i) {
+                    if (degrees[i] == threshold && threshold != 0) {
+                        tied.push_back(i);
+                    } else {
+                        //  Only the impacts of the tied shops are needed
+                        std::vector<uint64_t>().swap(neighbors[i]);
+                    }
+                }
+
+                if (exact_impacts) {
+                    for (auto &i : tied) {
+                        for (auto &each : neighbors[i]) {
+                            if (counted.insert(each, counted_degrees.size()) == counted_degrees.size()) {
+                                counted_degrees.push_back(0);
+                            }
+                        }
+                    }
+
+                    current = pass::neighbors;
+                } else {
+                    current = pass::done;
+                }
+            } else {
+                current = pass::done;
+            }
+        }
+
+        //  Loader interface, shops are only known from their roads
+        inline void reserve(const uint64_t, const uint64_t, const uint64_t = 0) noexcept {
+            //  Empty implementation
+        }
+
+        inline void find_or_register(const uint64_t) noexcept {
+            //  Empty implementation
+        }
+
+        inline size_t number_of_shops() const noexcept {
+            return 0;
+        }
+
+        inline void connect(const uint64_t from, const uint64_t to) {
+            switch (current) {
+                case pass::sketch:
+                    summary.add(from);
+                    summary.add(to);
+                    sketch.add(from);
+                    sketch.add(to);
+                    break;
+                case pass::degrees:
+                    count_candidate(from, to);
+                    count_candidate(to, from);
+                    break;
+                case pass::neighbors:
+                    count_neighbor(from);
+                    count_neighbor(to);
+                    break;
+                case pass::done:
+                    break;
+            }
+        }
+
+        /**
+         result()
+         The reduction over the candidates, once every pass is done.
+
+         @return The approximate result.
+         */
+        inline approximate_result result() const {
+            approximate_result outcome;
+            std::vector<uint64_t> impacts;
+
+            outcome.threshold = threshold;
+
+            for (auto &i : tied) {
+                uint64_t impact = 0;
+
+                for (auto &each : neighbors[i]) {
+                    const uint64_t degree = degree_of(each);
+                    impact += degree < threshold ? degree : 0;
+                }
+
+                impacts.push_back(impact);
+                outcome.required_impact = std::max(outcome.required_impact, impact);
+            }
+
+            for (size_t k = 0; k < tied.size(); ++k) {
+                if (impacts[k] == outcome.required_impact) {
+                    outcome.shops.push_back(candidate_identifiers[tied[k]]);
+                }
+            }
+
+            outcome.count = outcome.shops.size();
+
+            //  Shops of a higher count than total / capacity can't be missed
+            outcome.guaranteed = exact_impacts && threshold * summary.get_capacity() > summary.get_total();
+
+            return outcome;
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,158 @@
+#ifndef THOMAS_IDENTIFIER_MAP_HPP
+#define THOMAS_IDENTIFIER_MAP_HPP
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+namespace thomas {
+    /**
+     identifier_map
+     Index of the shops by identifier. Identifiers up to a known bound, such
+     as 1 to 1000 of the native format, are kept in a direct array, and the
+     others in an open addressing table with linear probing. Entries are
+     never removed, and the table is grown at half load.
+     */
+    class identifier_map {
+    private:
+        struct _slot {
+            uint64_t identifier;
+            size_t index;
+        };
+
+        //  Index by identifier, for identifiers below direct.size()
+        std::vector<size_t> direct;
+
+        std::vector<_slot> slots;
+        size_t shift = 64;
+        size_t occupied = 0;
+        size_t used = 0;
+
+        inline size_t slot_of(const uint64_t identifier) const noexcept {
+            //  Fibonacci hashing, the high bits spread consecutive identifiers
+            return static_cast<size_t>((identifier * 0x9e3779b97f4a7c15ull) >> shift);
+        }
+
+        inline void rehash(const size_t capacity) {
+            std::vector<_slot> previous(capacity, { 0, npos });
+
+            previous.swap(slots);
+            shift = 64 - static_cast<size_t>(std::countr_zero(capacity));
+
+            for (auto &each : previous) {
+                if (each.index != npos) {
+                    size_t slot = slot_of(each.identifier);
+
+                    while (slots[slot].index != npos) {
+                        slot = (slot + 1) & (slots.size() - 1);
+                    }
+
+                    slots[slot] = each;
+                }
+            }
+        }
+
+    public:
+        static constexpr size_t npos = SIZE_MAX;
+
+        //  Largest identifier bound worth a direct array, 64 MiB of indices
+        static constexpr uint64_t max_direct = uint64_t(1) << 23;
+
+        /**
+         reserve()
+         Pre-sizes the table for the given number of identifiers. When the
+         identifiers are known to be at most max_identifier, and the bound is
+         small enough, they are looked up in a direct array instead.
+         */
+        inline void reserve(const size_t count, const uint64_t max_identifier = 0) {
+            if (max_identifier != 0 && max_identifier < max_direct && direct.size() <= max_identifier && used == 0) {
+                direct.assign(static_cast<size_t>(max_identifier) + 1, npos);
+
+                //  Only stray identifiers above the bound are hashed
+                return;
+            }
+
+            //  Past a quarter of the address space the doubling below would overflow
+            if (count > SIZE_MAX / 4) {
+                throw std::length_error("identifier_map::reserve");
+            }
+
+            size_t capacity = 16;
+
+            while (capacity < 2 * count) {
+                capacity *= 2;
+            }
+
+            if (capacity > slots.size()) {
+                rehash(capacity);
+            }
+        }
+
+        inline size_t size() const noexcept {
+            return used;
+        }
+
+        /**
+         find()
+         Looks up the index of an identifier.
+
+         @return The index, npos when missing.
+         */
+        inline size_t find(const uint64_t identifier) const noexcept {
+            if (identifier < direct.size()) {
+                return direct[identifier];
+            }
+
+            if (slots.empty()) {
+                return npos;
+            }
+
+            for (size_t slot = slot_of(identifier); slots[slot].index != npos; slot = (slot + 1) & (slots.size() - 1)) {
+                if (slots[slot].identifier == identifier) {
+                    return slots[slot].index;
+                }
+            }
+
+            return npos;
+        }
+
+        /**
+         insert()
+         Adds an identifier with the given index, unless it is already present.
+
+         @return The index of the identifier, the given one when inserted.
+         */
+        inline size_t insert(const uint64_t identifier, const size_t index) {
+            if (identifier < direct.size()) {
+                if (direct[identifier] == npos) {
+                    direct[identifier] = index;
+                    ++used;
+                }
+
+                return direct[identifier];
+            }
+
+            if (2 * (occupied + 1) > slots.size()) {
+                rehash(slots.empty() ? 16 : 2 * slots.size());
+            }
+
+            size_t slot = slot_of(identifier);
+
+            for (; slots[slot].index != npos; slot = (slot + 1) & (slots.size() - 1)) {
+                if (slots[slot].identifier == identifier) {
+                    return slots[slot].index;
+                }
+            }
+
+            slots[slot] = { identifier, index };
+            ++occupied;
+            ++used;
+
+            return index;
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,185 @@
+#ifndef THOMAS_INPUT_HPP
+#define THOMAS_INPUT_HPP
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+namespace thomas {
+    /**
+     input
+     Line reader over a plain, gzip or zstd compressed file. The compression is
+     detected from the magic bytes, and compressed files are decoded on a
+     separate thread which hands chunks over to the reader as they are ready.
+     */
+    class input {
+    public:
+        enum class compression {
+            none,
+            gzip,
+            zstd
+        };
+
+    private:
+        static constexpr size_t chunk_size = 1 << 20;
+        static constexpr size_t queue_depth = 4;
+
+        std::FILE *file = nullptr;
+        compression kind = compression::none;
+
+        //  Bytes consumed while sniffing the magic number
+        std::vector<char> prefix;
+
+        std::thread worker;
+        std::mutex mutex;
+        std::condition_variable produced;
+        std::condition_variable consumed;
+        std::deque<std::vector<char>> chunks;
+        std::string error;
+        bool finished = false;
+        bool cancelled = false;
+
+        std::vector<char> current;
+        size_t position = 0;
+
+        inline void fail(const std::string &reason) {
+            std::lock_guard<std::mutex> lock(mutex);
+
+            if (error.empty()) {
+                error = reason;
+            }
+        }
+
+        inline bool push(std::vector<char> &&chunk) {
+            std::unique_lock<std::mutex> lock(mutex);
+
+            consumed.wait(lock, [this] { return chunks.size() < queue_depth || cancelled; });
+
+            if (cancelled) {
+                return false;
+            }
+
+            chunks.push_back(std::move(chunk));
+            produced.notify_one();
+
+            return true;
+        }
+
+        inline void finish() {
+            std::lock_guard<std::mutex> lock(mutex);
+
+            finished = true;
+            produced.notify_all();
+        }
+
+        void inflate_gzip();
+        void decompress_zstd();
+        void decode();
+
+        inline bool next_chunk() {
+            if (kind == compression::none) {
+                current.resize(chunk_size);
+                current.resize(std::fread(current.data(), 1, current.size(), file));
+                position = 0;
+
+                return !current.empty();
+            }
+
+            std::unique_lock<std::mutex> lock(mutex);
+
+            produced.wait(lock, [this] { return !chunks.empty() || finished; });
+
+            if (chunks.empty()) {
+                return false;
+            }
+
+            current = std::move(chunks.front());
+            chunks.pop_front();
+            position = 0;
+            consumed.notify_one();
+
+            return true;
+        }
+
+    public:
+        explicit input(const char *path);
+
+        input(const input &) = delete;
+        input &operator=(const input &) = delete;
+
+        virtual ~input() {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+
+                cancelled = true;
+                consumed.notify_all();
+            }
+
+            if (worker.joinable()) {
+                worker.join();
+            }
+
+            if (file != nullptr) {
+                std::fclose(file);
+            }
+        }
+
+        inline bool is_open() const noexcept {
+            return file != nullptr;
+        }
+
+        inline compression get_compression() const noexcept {
+            return kind;
+        }
+
+        inline bool has_failed() {
+            std::lock_guard<std::mutex> lock(mutex);
+
+            return !error.empty();
+        }
+
+        inline std::string get_error() {
+            std::lock_guard<std::mutex> lock(mutex);
+
+            return error;
+        }
+
+        /**
+         getline()
+         Reads the next line without the trailing newline character.
+
+         @return Whether a line has been read.
+         */
+        inline bool getline(std::string &line) {
+            line.clear();
+
+            for (;;) {
+                if (position == current.size() && !next_chunk()) {
+                    return !line.empty();
+                }
+
+                const char *begin = current.data() + position;
+                const size_t remaining = current.size() - position;
+                const char *newline = static_cast<const char *>(std::memchr(begin, '\n', remaining));
+
+                if (newline != nullptr) {
+                    line.append(begin, newline);
+                    position += static_cast<size_t>(newline - begin) + 1;
+
+                    return true;
+                }
+
+                line.append(begin, remaining);
+                position = current.size();
+            }
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,93 @@
+#ifndef THOMAS_INTERSECT_HPP
+#define THOMAS_INTERSECT_HPP
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace thomas {
+    /**
+     lower_bound_branchless()
+     Position of the first element not less than the value, in a sorted
+     array. The search halves a window without branching on the comparison,
+     so the loads don't depend on mispredicted branches.
+
+     @return The position, size when every element is less than the value.
+     */
+    inline size_t lower_bound_branchless(const uint32_t *values, size_t size, const uint32_t value) noexcept {
+        const uint32_t *base = values;
+
+        if (size == 0) {
+            return 0;
+        }
+
+        while (size > 1) {
+            const size_t half = size / 2;
+
+            base = base[half] < value ? base + half : base;
+            size -= half;
+        }
+
+        return static_cast<size_t>(base - values) + (*base < value);
+    }
+
+    /**
+     intersect_sorted()
+     Writes the values found in both of the sorted arrays, once each even
+     where an array repeats them. With SSE2, blocks of four values are
+     compared against each other at once and the block with the smaller
+     maximum is advanced; matches come out in ascending order either way, so
+     repeats are dropped against the last value written.
+
+     @param out Storage for at most min(size_a, size_b) values.
+     @return The number of values written.
+     */
+    inline size_t intersect_sorted(const uint32_t *a, const size_t size_a, const uint32_t *b, const size_t size_b, uint32_t *out) noexcept {
+        size_t i = 0, j = 0, count = 0;
+
+#ifdef __SSE2__
+        while (i + 4 <= size_a && j + 4 <= size_b) {
+            const __m128i block_a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(a + i));
+            const __m128i block_b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(b + j));
+
+            //  Every value of a against every rotation of b
+            const __m128i matches = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi32(block_a, block_b),
+                                                              _mm_cmpeq_epi32(block_a, _mm_shuffle_epi32(block_b, _MM_SHUFFLE(0, 3, 2, 1)))),
+                                                 _mm_or_si128(_mm_cmpeq_epi32(block_a, _mm_shuffle_epi32(block_b, _MM_SHUFFLE(1, 0, 3, 2))),
+                                                              _mm_cmpeq_epi32(block_a, _mm_shuffle_epi32(block_b, _MM_SHUFFLE(2, 1, 0, 3)))));
+
+            for (unsigned mask = static_cast<unsigned>(_mm_movemask_ps(_mm_castsi128_ps(matches))); mask != 0; mask &= mask - 1) {
+                out[count] = a[i + static_cast<size_t>(std::countr_zero(mask))];
+                count += count == 0 || out[count - 1] != out[count];
+            }
+
+            const uint32_t last_a = a[i + 3];
+            const uint32_t last_b = b[j + 3];
+
+            i += last_a <= last_b ? 4 : 0;
+            j += last_b <= last_a ? 4 : 0;
+        }
+#endif
+
+        while (i < size_a && j < size_b) {
+            if (a[i] < b[j]) {
+                ++i;
+            } else if (b[j] < a[i]) {
+                ++j;
+            } else {
+                out[count] = a[i];
+                count += count == 0 || out[count - 1] != out[count];
+                ++i;
+                ++j;
+            }
+        }
+
+        return count;
+    }
+}
+
+#endif
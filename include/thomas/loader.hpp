@@ -0,0 +1,171 @@
+#ifndef THOMAS_LOADER_HPP
+#define THOMAS_LOADER_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#include "thomas/input.hpp"
+#include "thomas/edge_list.hpp"
+#include "thomas/heavy_hitters.hpp"
+#include "thomas/network.hpp"
+#include "thomas/status.hpp"
+
+namespace thomas {
+    enum class format {
+        native,
+        metis,
+        matrix_market,
+        snap,
+        arrow
+    };
+
+    inline bool format_from_name(const std::string &name, format &result) noexcept {
+        if (name == "native") {
+            result = format::native;
+        } else if (name == "metis") {
+            result = format::metis;
+        } else if (name == "mtx") {
+            result = format::matrix_market;
+        } else if (name == "snap") {
+            result = format::snap;
+        } else if (name == "arrow") {
+            result = format::arrow;
+        } else {
+            return false;
+        }
+
+        return true;
+    }
+
+    /**
+     format_from_path()
+     Guesses the format from the file extension, ignoring compression suffixes.
+
+     @return The guessed format, native when the extension is not known.
+     */
+    inline format format_from_path(std::string path) {
+        for (const char *suffix : { ".gz", ".zst" }) {
+            const size_t length = std::strlen(suffix);
+
+            if (path.size() > length && path.compare(path.size() - length, length, suffix) == 0) {
+                path.resize(path.size() - length);
+            }
+        }
+
+        const size_t dot = path.find_last_of('.');
+        const std::string extension = dot == std::string::npos ? std::string() : path.substr(dot + 1);
+
+        if (extension == "graph" || extension == "metis") {
+            return format::metis;
+        } else if (extension == "mtx") {
+            return format::matrix_market;
+        } else if (extension == "snap" || extension == "edges") {
+            return format::snap;
+        } else if (extension == "arrow" || extension == "feather") {
+            return format::arrow;
+        }
+
+        return format::native;
+    }
+
+    //  Largest declared count the importers reserve storage for by default,
+    //  about 32 MiB of shop index; larger inputs grow as they are read
+    constexpr uint64_t default_max_reservation = uint64_t(1) << 20;
+
+    enum class header_mode {
+        trust,
+        verify,
+        ignore,
+        none
+    };
+
+    inline bool header_mode_from_name(const std::string &name, header_mode &result) noexcept {
+        if (name == "trust") {
+            result = header_mode::trust;
+        } else if (name == "verify") {
+            result = header_mode::verify;
+        } else if (name == "ignore") {
+            result = header_mode::ignore;
+        } else if (name == "none") {
+            result = header_mode::none;
+        } else {
+            return false;
+        }
+
+        return true;
+    }
+
+    /**
+     import_native()
+     Reads the assignment format: a "num_shops num_roads" header followed by
+     one road per line. Roads with a source shop out of range are skipped.
+
+     A trusted header bounds the counts and the number of roads read, as the
+     assignment requires. Otherwise the roads are read up to the end of file.
+     A verified header has its counts compared with what has been read, a
+     mismatch being a range error under either error policy; an ignored one
+     is skipped, and there is none at all for header-less files.
+     A trusted header pre-sizes the network for its counts, a verified one
+     only up to max_reservation, as its counts may be anything.
+
+     Numbers are whole blank separated fields, so a sign or a suffix such as
+     "2x" is a parse error, and fields after the pair are ignored. A loop on
+     a shop lists the shop twice in its own connections, also when the loop
+     is the first road of the shop.
+
+     @return The status of the load, errors are collected into the buffer.
+     */
+    template <typename Network>
+    status import_native(input &in, Network &network, error_buffer &errors, const header_mode header = header_mode::trust,
+                         const uint64_t max_reservation = default_max_reservation);
+
+    /**
+     import_metis()
+     Reads a METIS graph: a "n m [fmt [ncon]]" header followed by the adjacency
+     of vertex i on line i. Each undirected edge is listed by both of its
+     vertices, so it is added once from the lower numbered side. A malformed
+     adjacency line still counts as a vertex when it is skipped. The network
+     is pre-sized for the declared counts up to max_reservation.
+
+     @return The status of the load, errors are collected into the buffer.
+     */
+    template <typename Network>
+    status import_metis(input &in, Network &network, error_buffer &errors, const uint64_t max_reservation = default_max_reservation);
+
+    /**
+     import_matrix_market()
+     Reads a Matrix Market coordinate file, each stored entry "i j [value]"
+     becomes a road. Symmetric matrices only store one triangle, while general
+     matrices listing both (i, j) and (j, i) yield two parallel roads. The
+     network is pre-sized for the size line up to max_reservation.
+
+     @return The status of the load, errors are collected into the buffer.
+     */
+    template <typename Network>
+    status import_matrix_market(input &in, Network &network, error_buffer &errors, const uint64_t max_reservation = default_max_reservation);
+
+    /**
+     import_snap()
+     Reads a SNAP edge list: one "from to" pair per line, lines starting with
+     '#' are comments.
+
+     @return The status of the load, errors are collected into the buffer.
+     */
+    template <typename Network>
+    status import_snap(input &in, Network &network, error_buffer &errors);
+
+    /**
+     import()
+     Reads a network in the given format. Networks are loaded either into a
+     thomas::network, into a thomas::edge_list to be compressed afterwards,
+     or streamed through a pass of thomas::heavy_hitters.
+
+     @return The status of the load, errors are collected into the buffer.
+     */
+    template <typename Network>
+    status import(const format format, input &in, Network &network, error_buffer &errors, const header_mode header = header_mode::trust,
+                  const uint64_t max_reservation = default_max_reservation);
+}
+
+#endif
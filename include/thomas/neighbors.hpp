@@ -0,0 +1,165 @@
+#ifndef THOMAS_NEIGHBORS_HPP
+#define THOMAS_NEIGHBORS_HPP
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <ranges>
+#include <span>
+
+#include "thomas/shop.hpp"
+
+namespace thomas {
+    /**
+     shop_neighbors
+     View of the connections of a shop as the indices of the connected shops,
+     in the order of the connection list, repeats included.
+     */
+    class shop_neighbors : public std::ranges::view_interface<shop_neighbors> {
+    private:
+        shop *const *first = nullptr;
+        shop *const *last = nullptr;
+
+    public:
+        class iterator {
+        private:
+            shop *const *position = nullptr;
+
+        public:
+            using iterator_concept = std::forward_iterator_tag;
+            using value_type = size_t;
+            using difference_type = std::ptrdiff_t;
+
+            iterator() = default;
+
+            explicit iterator(shop *const *position) noexcept : position(position) {
+                //  Empty implementation
+            }
+
+            inline size_t operator*() const noexcept {
+                return (*position)->get_index();
+            }
+
+            inline iterator &operator++() noexcept {
+                ++position;
+                return *this;
+            }
+
+            inline iterator operator++(int) noexcept {
+                iterator previous = *this;
+                ++position;
+                return previous;
+            }
+
+            inline bool operator==(const iterator &other) const noexcept = default;
+        };
+
+        shop_neighbors() = default;
+
+        shop_neighbors(shop *const *first, shop *const *last) noexcept : first(first), last(last) {
+            //  Empty implementation
+        }
+
+        inline iterator begin() const noexcept {
+            return iterator(first);
+        }
+
+        inline iterator end() const noexcept {
+            return iterator(last);
+        }
+
+        inline size_t size() const noexcept {
+            return static_cast<size_t>(last - first);
+        }
+    };
+
+    /**
+     bitset_neighbors
+     View of a row of an adjacency bitset as the indices of the set bits, in
+     ascending order.
+     */
+    class bitset_neighbors : public std::ranges::view_interface<bitset_neighbors> {
+    private:
+        const uint64_t *words = nullptr;
+        size_t count = 0;
+
+    public:
+        class iterator {
+        private:
+            const uint64_t *words = nullptr;
+            size_t word = 0;
+            size_t count = 0;
+            uint64_t bits = 0;
+
+            inline void skip_empty() noexcept {
+                while (bits == 0 && word < count) {
+                    if (++word < count) {
+                        bits = words[word];
+                    }
+                }
+            }
+
+        public:
+            using iterator_concept = std::forward_iterator_tag;
+            using value_type = size_t;
+            using difference_type = std::ptrdiff_t;
+
+            iterator() = default;
+
+            iterator(const uint64_t *words, const size_t word, const size_t count) noexcept
+                : words(words), word(word), count(count), bits(word < count ? words[word] : 0) {
+                skip_empty();
+            }
+
+            inline size_t operator*() const noexcept {
+                return word * 64 + static_cast<size_t>(std::countr_zero(bits));
+            }
+
+            inline iterator &operator++() noexcept {
+                bits &= bits - 1;
+                skip_empty();
+                return *this;
+            }
+
+            inline iterator operator++(int) noexcept {
+                iterator previous = *this;
+                ++*this;
+                return previous;
+            }
+
+            inline bool operator==(const iterator &other) const noexcept {
+                return word == other.word && bits == other.bits;
+            }
+        };
+
+        bitset_neighbors() = default;
+
+        bitset_neighbors(const uint64_t *words, const size_t count) noexcept : words(words), count(count) {
+            //  Empty implementation
+        }
+
+        inline iterator begin() const noexcept {
+            return iterator(words, 0, count);
+        }
+
+        inline iterator end() const noexcept {
+            return iterator(words, count, count);
+        }
+
+        inline size_t size() const noexcept {
+            size_t total = 0;
+
+            for (size_t w = 0; w < count; ++w) {
+                total += static_cast<size_t>(std::popcount(words[w]));
+            }
+
+            return total;
+        }
+    };
+
+    //  Neighbors of a shop in a compact, sorted index array
+    using index_neighbors = std::span<const uint32_t>;
+}
+
+#endif
@@ -0,0 +1,562 @@
+#ifndef THOMAS_NETWORK_HPP
+#define THOMAS_NETWORK_HPP
+
+#include <cstdint>
+#include <vector>
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+
+#include "thomas/config.hpp"
+#include "thomas/dense_network.hpp"
+#include "thomas/graph_backend.hpp"
+#include "thomas/identifier_map.hpp"
+#include "thomas/intersect.hpp"
+#include "thomas/neighbors.hpp"
+#include "thomas/reduce_result.hpp"
+#include "thomas/reduce_workspace.hpp"
+#include "thomas/shop.hpp"
+
+namespace thomas {
+    class network {
+    private:
+        //  Shops in the order of registration, owned by the network
+        std::vector<thomas::shop *> shops;
+        identifier_map identifiers;
+
+        //  Expected number of connections of a shop, from reserve()
+        static constexpr size_t max_degree_hint = 64;
+        size_t degree_hint = 0;
+
+        reduce_workspace workspace;
+
+        //  Sorted and deduplicated neighbor indices by shop, from finalize()
+        std::vector<uint64_t> offsets;
+        std::vector<uint32_t> targets;
+        uint64_t parallel_roads = 0;
+        bool finalized = false;
+
+        //  Adjacency matrix of small, dense and simple networks, from finalize()
+        dense_network dense;
+        bool has_dense = false;
+
+    public:
+        inline std::vector<thomas::shop *> &get_shops() noexcept {
+            return shops;
+        }
+
+        explicit network() {
+            //  Empty implementation
+        }
+
+        virtual ~network() {
+            for (auto &each_shop : shops) {
+                delete each_shop;
+            }
+
+            shops.clear();
+        }
+
+        inline shop *shop_at(const uint64_t i) {
+            const size_t index = identifiers.find(i);
+
+            if (index == identifier_map::npos) {
+                throw std::out_of_range("no shop with identifier " + std::to_string(i));
+            }
+
+            return shops[index];
+        }
+
+        inline size_t number_of_shops() const noexcept {
+            return shops.size();
+        }
+
+        inline uint64_t identifier_at(const size_t index) const noexcept {
+            return shops[index]->get_identifier();
+        }
+
+        inline size_t degree(const size_t index) const noexcept {
+            return shops[index]->get_connected_shops().size();
+        }
+
+        /**
+         neighbors()
+         Indices of the shops connected to the shop at the given index, in the
+         order of its connections.
+         */
+        inline shop_neighbors neighbors(const size_t index) const noexcept {
+            const std::vector<shop *> &connections = shops[index]->get_connected_shops();
+
+            return shop_neighbors(connections.data(), connections.data() + connections.size());
+        }
+
+        inline void register_shop(shop *shop) {
+            if (identifiers.insert(shop->get_identifier(), shops.size()) == shops.size()) {
+                shop->set_index(shops.size());
+                shops.push_back(shop);
+                finalized = false;
+            }
+        }
+
+        /**
+         reserve()
+         Pre-sizes the shop storage and the identifier index for the expected
+         counts, and the connections of each new shop for the average degree.
+         Identifiers known to be at most max_identifier are indexed directly.
+         */
+        inline void reserve(const uint64_t num_shops, const uint64_t num_roads, const uint64_t max_identifier = 0) {
+            shops.reserve(static_cast<size_t>(num_shops));
+            identifiers.reserve(static_cast<size_t>(num_shops), max_identifier);
+
+            //  Every road is listed by both of its ends, and the hint is bounded
+            //  as it sizes the connections of every shop
+            if (num_shops == 0) {
+                degree_hint = 0;
+            } else if (num_roads / num_shops >= max_degree_hint / 2) {
+                degree_hint = max_degree_hint;
+            } else {
+                degree_hint = static_cast<size_t>((2 * num_roads + num_shops - 1) / num_shops);
+            }
+        }
+
+        /**
+         find_or_register()
+         Looks up the shop with the given identifier, instantiating it when missing.
+
+         @return The shop with the given identifier.
+         */
+        inline shop *find_or_register(const uint64_t identifier) {
+            const size_t index = identifiers.insert(identifier, shops.size());
+
+            if (index != shops.size()) {
+                return shops[index];
+            }
+
+            THOMAS_DEBUG_STREAM << "shop with identifier " << identifier << " is being instantiated" << std::endl;
+
+            shop *new_shop = new shop(identifier);
+            new_shop->get_connected_shops().reserve(degree_hint);
+            new_shop->set_index(shops.size());
+
+            shops.push_back(new_shop);
+            finalized = false;
+
+            return new_shop;
+        }
+
+        /**
+         connect()
+         Adds a road in between two shops, instantiating the shops when missing.
+         */
+        inline void connect(const uint64_t from, const uint64_t to) {
+            shop *source = find_or_register(from);
+            shop *destination = find_or_register(to);
+
+            destination->get_connected_shops().push_back(source);
+            source->get_connected_shops().push_back(destination);
+
+            finalized = false;
+        }
+
+        /**
+         disconnect()
+         Removes one road in between two shops. Shops left without roads stay
+         registered, and the order of the remaining connections may change.
+
+         @return Whether there was such a road.
+         */
+        inline bool disconnect(const uint64_t from, const uint64_t to) {
+            const size_t source = identifiers.find(from);
+            const size_t destination = identifiers.find(to);
+
+            if (source == identifier_map::npos || destination == identifier_map::npos) {
+                return false;
+            }
+
+            std::vector<shop *> &outgoing = shops[source]->get_connected_shops();
+            std::vector<shop *> &incoming = shops[destination]->get_connected_shops();
+            auto position = std::find(outgoing.begin(), outgoing.end(), shops[destination]);
+
+            if (position == outgoing.end()) {
+                return false;
+            }
+
+            //  Swap removal, a loop is listed twice in the same list
+            *position = outgoing.back();
+            outgoing.pop_back();
+
+            position = std::find(incoming.begin(), incoming.end(), shops[source]);
+            *position = incoming.back();
+            incoming.pop_back();
+
+            finalized = false;
+
+            return true;
+        }
+
+        /**
+         finalize()
+         Sorts the connections of every shop by index, and builds the sorted
+         neighbor indices of each shop with parallel roads merged, which back
+         has_edge() and common_neighbors(). Small and dense networks without
+         parallel roads or loops also get their adjacency matrix, which backs
+         reduce(). Connecting shops afterwards undoes it, until the next call.
+         The neighbor indices are 32 bits wide, so it throws length_error
+         beyond 2^32 shops, leaving the network unfinalized.
+         */
+        inline void finalize() {
+            if (shops.size() > uint64_t(UINT32_MAX) + 1) {
+                throw std::length_error("network::finalize");
+            }
+
+            offsets.resize(shops.size() + 1);
+            targets.clear();
+            parallel_roads = 0;
+            offsets[0] = 0;
+
+            for (size_t i = 0; i < shops.size(); ++i) {
+                std::vector<shop *> &connections = shops[i]->get_connected_shops();
+
+                std::sort(connections.begin(), connections.end(), [] (shop *lhs, shop *rhs) {
+                    return lhs->get_index() < rhs->get_index();
+                });
+
+                for (size_t k = 0; k < connections.size(); ++k) {
+                    const uint32_t target = static_cast<uint32_t>(connections[k]->get_index());
+
+                    //  Repeats are adjacent once sorted
+                    if (k != 0 && connections[k - 1] == connections[k]) {
+                        ++parallel_roads;
+                        continue;
+                    }
+
+                    targets.push_back(target);
+                }
+
+                offsets[i + 1] = targets.size();
+            }
+
+            has_dense = dense_network::is_preferred(shops.size(), targets.size() + parallel_roads) && dense.assign(shops);
+            finalized = true;
+        }
+
+        /**
+         sorted_neighbors()
+         Indices of the shops connected to the shop at the given index, in
+         ascending order and without repeats. Requires finalize().
+         */
+        inline index_neighbors sorted_neighbors(const size_t index) const noexcept {
+            return index_neighbors(targets.data() + offsets[index], offsets[index + 1] - offsets[index]);
+        }
+
+        inline bool is_finalized() const noexcept {
+            return finalized;
+        }
+
+        /**
+         number_of_parallel_roads()
+         Connections merged by the last finalize() for repeating an earlier
+         one of the same shop. A repeated road counts at both of its ends, and
+         a loop, which lists its shop twice, counts once.
+         */
+        inline uint64_t number_of_parallel_roads() const noexcept {
+            return parallel_roads;
+        }
+
+        /**
+         has_edge()
+         Checks whether the shops at the given indices are connected, with a
+         binary search in the shorter neighbor list once finalized, and a
+         linear scan otherwise.
+         */
+        inline bool has_edge(const size_t a, const size_t b) noexcept {
+            if (!finalized) {
+                const std::vector<shop *> &connections = shops[a]->get_connected_shops();
+
+                return std::find(connections.begin(), connections.end(), shops[b]) != connections.end();
+            }
+
+            const bool shorter = offsets[a + 1] - offsets[a] <= offsets[b + 1] - offsets[b];
+            const size_t from = shorter ? a : b;
+            const uint32_t to = static_cast<uint32_t>(shorter ? b : a);
+            const uint32_t *row = targets.data() + offsets[from];
+            const size_t size = offsets[from + 1] - offsets[from];
+            const size_t position = lower_bound_branchless(row, size, to);
+
+            return position != size && row[position] == to;
+        }
+
+        /**
+         common_neighbors()
+         Indices of the shops connected to both of the given shops, in
+         ascending order. Requires finalize().
+
+         @param out The common neighbors, replaced.
+         @return The number of common neighbors.
+         */
+        inline size_t common_neighbors(const size_t a, const size_t b, std::vector<uint32_t> &out) const {
+            const size_t size_a = offsets[a + 1] - offsets[a];
+            const size_t size_b = offsets[b + 1] - offsets[b];
+
+            out.resize(std::min(size_a, size_b));
+            out.resize(intersect_sorted(targets.data() + offsets[a], size_a, targets.data() + offsets[b], size_b, out.data()));
+
+            return out.size();
+        }
+
+        inline uint64_t number_of_connections() const noexcept {
+            return thomas::count_connections(*this);
+        }
+
+        /**
+         order_by_degree()
+         Orders the shops by number of connections descending, keeping the order
+         of registration among equal degrees. Degrees are bounded by the number
+         of roads, so a counting sort over them takes linear time. With more than
+         one thread, each thread counts and places a contiguous range of shops
+         into its own histogram, so threads are only used while the histograms
+         stay within the number of shops.
+
+         @param sorted The shops in degree order, replaced.
+         @param counts Histogram storage, reused in between calls.
+         @param threads Number of threads to use.
+         */
+        inline void order_by_degree(std::vector<shop *> &sorted, std::vector<size_t> &counts, unsigned threads = 1) const {
+            const size_t count = shops.size();
+            size_t max_degree = 0;
+
+            for (auto &each_shop : shops) {
+                max_degree = std::max(max_degree, each_shop->get_connected_shops().size());
+            }
+
+            const size_t buckets = max_degree + 1;
+
+            //  Small inputs don't pay for the threads, nor do hubs for their histograms
+            threads = count < 65536 ? 1u : static_cast<unsigned>(std::max<size_t>(1, std::min<size_t>(threads, count / buckets)));
+            const size_t range = (count + threads - 1) / threads;
+
+            counts.assign(buckets * threads, 0);
+            sorted.resize(count);
+
+            auto run = [&] (auto &&step) {
+                std::vector<std::thread> workers;
+
+                if (threads > 1) {
+                    workers.reserve(threads - 1);
+                }
+
+                for (unsigned t = 1; t < threads; ++t) {
+                    workers.emplace_back(step, t);
+                }
+
+                step(0u);
+
+                for (auto &worker : workers) {
+                    worker.join();
+                }
+            };
+
+            run([&] (unsigned t) {
+                size_t *histogram = counts.data() + t * buckets;
+                const size_t end = std::min(count, (t + 1) * range);
+
+                for (size_t i = t * range; i < end; ++i) {
+                    ++histogram[max_degree - shops[i]->get_connected_shops().size()];
+                }
+            });
+
+            //  Exclusive prefix sum, degree major so that the ranges stay in order
+            size_t offset = 0;
+
+            for (size_t d = 0; d < buckets; ++d) {
+                for (unsigned t = 0; t < threads; ++t) {
+                    const size_t bucket = counts[t * buckets + d];
+
+                    counts[t * buckets + d] = offset;
+                    offset += bucket;
+                }
+            }
+
+            run([&] (unsigned t) {
+                size_t *positions = counts.data() + t * buckets;
+                const size_t end = std::min(count, (t + 1) * range);
+
+                for (size_t i = t * range; i < end; ++i) {
+                    sorted[positions[max_degree - shops[i]->get_connected_shops().size()]++] = shops[i];
+                }
+            });
+        }
+
+        /**
+         external_impact()
+         Sums the degrees of the neighbors below the threshold, that is the ones
+         outside of the tie set. Each neighbor is a dependent load into a random
+         shop, so the shops a few neighbors ahead are prefetched.
+
+         @param distance Number of neighbors to prefetch ahead, 0 disables it.
+         @return The external impact of the shop.
+         */
+        static inline uint64_t external_impact(shop *el, const uint64_t threshold, const size_t distance = prefetch_distance) noexcept {
+            const std::vector<shop *> &connections = el->get_connected_shops();
+            const size_t count = connections.size();
+            const size_t ahead = count > distance ? count - distance : 0;
+            uint64_t impact = 0;
+            size_t k = 0;
+
+            for (size_t p = 0; distance != 0 && p < distance && p < count; ++p) {
+                THOMAS_PREFETCH(connections[p]);
+            }
+
+            for (; k < ahead; ++k) {
+                THOMAS_PREFETCH(connections[k + distance]);
+
+                const uint64_t degree = connections[k]->get_connected_shops().size();
+                impact += degree < threshold ? degree : 0;
+            }
+
+            for (; k < count; ++k) {
+                const uint64_t degree = connections[k]->get_connected_shops().size();
+                impact += degree < threshold ? degree : 0;
+            }
+
+            return impact;
+        }
+
+        inline uint64_t external_impact(const size_t index, const uint64_t threshold) const noexcept {
+            return external_impact(shops[index], threshold);
+        }
+
+        inline reduce_workspace &get_workspace() noexcept {
+            return workspace;
+        }
+
+        /**
+         reduce()
+         Reduces the network one step down by disposing nodes to two subtle parts.
+         Once finalized, small and dense networks are reduced over their bitset
+         adjacency matrix. The temporaries are kept in the workspace of the network.
+
+         @return The number of nodes disposed.
+         */
+        inline uint64_t reduce() noexcept {
+            return reduce(workspace);
+        }
+
+        /**
+         reduce()
+         Same as reduce(), with the temporaries kept in the given workspace.
+
+         @return The number of nodes disposed.
+         */
+        inline uint64_t reduce(reduce_workspace &workspace) noexcept {
+            const size_t previous_capacity = workspace.capacity_bytes();
+            uint64_t disposed;
+
+            if (finalized && has_dense) {
+                disposed = dense.reduce();
+            } else {
+                //  Parallel roads and loops fall back to the connection lists
+                disposed = reduce_connections(workspace);
+            }
+
+            workspace.note_growth(previous_capacity);
+
+            return disposed;
+        }
+
+        /**
+         reduce_connections()
+         reduce() over the connection lists of the shops.
+
+         @return The number of nodes disposed.
+         */
+        inline uint64_t reduce_connections() noexcept {
+            return reduce_connections(workspace);
+        }
+
+        inline uint64_t reduce_connections(reduce_workspace &workspace) noexcept {
+            std::vector<shop *> &linear_shops = workspace.linear_shops;
+
+            if (shops.empty()) {
+                return 0;
+            }
+
+            //  Sort the linear container with number of connections
+            order_by_degree(linear_shops, workspace.counts, std::thread::hardware_concurrency());
+
+            const uint64_t threshold = linear_shops.front()->get_connected_shops().size();
+
+            THOMAS_DEBUG_STREAM << "reducing with threshold value of " << threshold << std::endl;
+
+            //  Filter out the elements with connection size lower than threshold value
+            linear_shops.erase(std::remove_if(linear_shops.begin(),
+                                              linear_shops.end(),
+                                              [&threshold] (shop *el) {
+                return el->get_connected_shops().size() < threshold;
+            }), linear_shops.end());
+
+            std::vector<uint64_t> &impacts = workspace.impacts;
+
+            impacts.clear();
+
+            //  Find the external impact of each node
+            std::for_each(linear_shops.begin(),
+                          linear_shops.end(),
+                          [&impacts,
+                           &threshold] (shop *el) {
+                impacts.push_back(external_impact(el, threshold));
+            });
+
+            //  Sort the array with impact values descending
+            std::sort(impacts.begin(),
+                      impacts.end(),
+                      [] (uint64_t lhs,
+                          uint64_t rhs) {
+                return lhs > rhs;
+            });
+
+            const uint64_t required_impact = impacts.front();
+
+            //  Filter out the elements with impact lower than required
+            impacts.erase(std::remove_if(impacts.begin(),
+                                         impacts.end(),
+                                         [&required_impact /* clang-capture-default */] (uint64_t el) {
+                 return el < required_impact;
+             }), impacts.end());
+
+            //  If the number of elements remaining is lower than two, no further action is required
+            if (impacts.size() < 2) {
+                return 0;
+            }
+
+            return impacts.size();
+        }
+
+        /**
+         analyze()
+         Same reduction as reduce(), keeping the shops which tied at the
+         required impact along with the threshold and the required impact.
+
+         @return The result of the reduction.
+         */
+        inline reduce_result analyze() noexcept {
+            return analyze(workspace);
+        }
+
+        inline reduce_result analyze(reduce_workspace &workspace) noexcept {
+            const size_t previous_capacity = workspace.capacity_bytes();
+            const reduce_result result = thomas::analyze(*this, workspace.impacts, workspace.disposed);
+
+            workspace.note_growth(previous_capacity);
+
+            return result;
+        }
+
+        friend std::ostream &operator<<(std::ostream &os, network &network);
+    };
+
+    std::ostream &operator<<(std::ostream &os, network &network);
+}
+
+#endif
@@ -0,0 +1,236 @@
+#ifndef THOMAS_NETWORK_DIFF_HPP
+#define THOMAS_NETWORK_DIFF_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "thomas/graph_backend.hpp"
+#include "thomas/identifier_map.hpp"
+#include "thomas/network.hpp"
+#include "thomas/radix_sort.hpp"
+#include "thomas/status.hpp"
+
+namespace thomas {
+    /**
+     network_diff
+     Roads added and removed in between two snapshots of a network, with
+     the change in degree of every affected shop and the reduction of both
+     snapshots. Roads and shops are given by identifier.
+     */
+    struct network_diff {
+        struct road {
+            uint64_t from;
+            uint64_t to;
+        };
+
+        struct degree_delta {
+            uint64_t identifier;
+            int64_t delta;
+        };
+
+        struct reduction {
+            uint64_t threshold = 0;
+            uint64_t required_impact = 0;
+            uint64_t disposed = 0;
+        };
+
+        std::vector<road> added;
+        std::vector<road> removed;
+        std::vector<degree_delta> degrees;
+
+        reduction before;
+        reduction after;
+
+        /**
+         apply()
+         Turns a network holding the roads of the first snapshot into one with
+         the roads of the second, one road at a time.
+
+         @return Whether every removed road was found.
+         */
+        inline bool apply(network &network) const {
+            bool found = true;
+
+            for (auto &each : removed) {
+                found = network.disconnect(each.from, each.to) && found;
+            }
+
+            for (auto &each : added) {
+                network.connect(each.from, each.to);
+            }
+
+            return found;
+        }
+    };
+
+    /**
+     _collect_roads()
+     Keys of the roads of a network over indices shared in between both
+     snapshots, the lower index first. A road is listed by both of its
+     ends, and a loop twice by its shop, so each is only kept once.
+     */
+    template <graph_backend Graph>
+    inline void _collect_roads(const Graph &graph, identifier_map &shared, std::vector<uint64_t> &identifiers, std::vector<uint64_t> &keys) {
+        std::vector<uint32_t> indices(graph.number_of_shops());
+
+        for (size_t i = 0; i < graph.number_of_shops(); ++i) {
+            const uint64_t identifier = graph.identifier_at(i);
+            const size_t index = shared.insert(identifier, identifiers.size());
+
+            if (index == identifiers.size()) {
+                identifiers.push_back(identifier);
+            }
+
+            indices[i] = static_cast<uint32_t>(index);
+        }
+
+        for (size_t i = 0; i < graph.number_of_shops(); ++i) {
+            size_t loops = 0;
+
+            for (auto each : graph.neighbors(i)) {
+                const size_t j = static_cast<size_t>(each);
+
+                if (j > i || (j == i && loops++ % 2 == 0)) {
+                    keys.push_back(pack_edge(std::min(indices[i], indices[j]), std::max(indices[i], indices[j])));
+                }
+            }
+        }
+    }
+
+    /**
+     _merge_roads()
+     Multiset difference of two sorted key ranges: a key repeated more in
+     the second range is added that many more times, and removed the other
+     way round.
+     */
+    inline void _merge_roads(const uint64_t *a, const uint64_t *a_end, const uint64_t *b, const uint64_t *b_end, std::vector<uint64_t> &added, std::vector<uint64_t> &removed) {
+        while (a != a_end || b != b_end) {
+            const uint64_t key = (b == b_end || (a != a_end && *a < *b)) ? *a : *b;
+            size_t count_a = 0, count_b = 0;
+
+            for (; a != a_end && *a == key; ++a) {
+                ++count_a;
+            }
+
+            for (; b != b_end && *b == key; ++b) {
+                ++count_b;
+            }
+
+            for (; count_b > count_a; --count_b) {
+                added.push_back(key);
+            }
+
+            for (; count_a > count_b; --count_a) {
+                removed.push_back(key);
+            }
+        }
+    }
+
+    /**
+     diff_networks()
+     Compares two snapshots of a network. The roads of both are sorted as
+     packed keys with radix_sort(), and merged in linear time; with more than
+     one thread, each merges a range of keys split at the same values in both
+     snapshots. Shops of both snapshots together are indexed with 32 bits.
+
+     @return The status of the comparison, a range error when there are too many shops.
+     */
+    template <graph_backend Before, graph_backend After>
+    inline status diff_networks(const Before &before, const After &after, network_diff &diff, unsigned threads = std::thread::hardware_concurrency()) {
+        identifier_map shared;
+        std::vector<uint64_t> identifiers;
+        std::vector<uint64_t> keys_before, keys_after, buffer;
+
+        if (static_cast<uint64_t>(before.number_of_shops()) + after.number_of_shops() > UINT32_MAX) {
+            return status::range_error;
+        }
+
+        shared.reserve(before.number_of_shops() + after.number_of_shops());
+        keys_before.reserve(static_cast<size_t>(count_connections(before) / 2));
+        keys_after.reserve(static_cast<size_t>(count_connections(after) / 2));
+
+        _collect_roads(before, shared, identifiers, keys_before);
+        _collect_roads(after, shared, identifiers, keys_after);
+
+        radix_sort(keys_before, buffer, threads);
+        radix_sort(keys_after, buffer, threads);
+
+        //  Split points at key values, so that equal keys stay in one range
+        const std::vector<uint64_t> &larger = keys_before.size() >= keys_after.size() ? keys_before : keys_after;
+        const size_t ranges = larger.size() < 65536 ? 1 : std::max(1u, threads);
+        std::vector<size_t> splits_before(ranges + 1), splits_after(ranges + 1);
+
+        splits_before[0] = splits_after[0] = 0;
+        splits_before[ranges] = keys_before.size();
+        splits_after[ranges] = keys_after.size();
+
+        for (size_t r = 1; r < ranges; ++r) {
+            const uint64_t key = larger[r * larger.size() / ranges];
+
+            splits_before[r] = static_cast<size_t>(std::lower_bound(keys_before.begin(), keys_before.end(), key) - keys_before.begin());
+            splits_after[r] = static_cast<size_t>(std::lower_bound(keys_after.begin(), keys_after.end(), key) - keys_after.begin());
+        }
+
+        std::vector<std::vector<uint64_t>> added(ranges), removed(ranges);
+
+        const auto merge = [&] (const size_t r) {
+            _merge_roads(keys_before.data() + splits_before[r], keys_before.data() + splits_before[r + 1],
+                         keys_after.data() + splits_after[r], keys_after.data() + splits_after[r + 1],
+                         added[r], removed[r]);
+        };
+
+        std::vector<std::thread> workers;
+
+        for (size_t r = 1; r < ranges; ++r) {
+            workers.emplace_back(merge, r);
+        }
+
+        merge(0);
+
+        for (auto &worker : workers) {
+            worker.join();
+        }
+
+        //  Degrees only change through the roads which differ
+        std::vector<int64_t> deltas(identifiers.size(), 0);
+
+        diff.added.clear();
+        diff.removed.clear();
+        diff.degrees.clear();
+
+        for (size_t r = 0; r < ranges; ++r) {
+            for (auto &key : added[r]) {
+                diff.added.push_back({ identifiers[edge_source(key)], identifiers[edge_target(key)] });
+                ++deltas[edge_source(key)];
+                ++deltas[edge_target(key)];
+            }
+
+            for (auto &key : removed[r]) {
+                diff.removed.push_back({ identifiers[edge_source(key)], identifiers[edge_target(key)] });
+                --deltas[edge_source(key)];
+                --deltas[edge_target(key)];
+            }
+        }
+
+        for (size_t i = 0; i < identifiers.size(); ++i) {
+            if (deltas[i] != 0) {
+                diff.degrees.push_back({ identifiers[i], deltas[i] });
+            }
+        }
+
+        std::vector<uint64_t> impacts;
+        std::vector<size_t> disposed;
+        reduce_result result = analyze(before, impacts, disposed);
+
+        diff.before = { result.threshold, result.required_impact, result.disposed() };
+        result = analyze(after, impacts, disposed);
+        diff.after = { result.threshold, result.required_impact, result.disposed() };
+
+        return status::ok;
+    }
+}
+
+#endif
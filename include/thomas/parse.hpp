@@ -0,0 +1,72 @@
+#ifndef THOMAS_PARSE_HPP
+#define THOMAS_PARSE_HPP
+
+#include <cstdint>
+#include <string>
+
+namespace thomas {
+    inline bool is_blank(const char character) noexcept {
+        return character == ' ' || character == '\t' || character == '\r';
+    }
+
+    inline void skip_blanks(const char *&cursor, const char *end) noexcept {
+        while (cursor != end && is_blank(*cursor)) {
+            ++cursor;
+        }
+    }
+
+    /**
+     parse_unsigned()
+     Parses a decimal unsigned integer after skipping the leading blanks. The
+     number should be followed by a blank or the end of the line.
+
+     @return Whether a number has been parsed, the cursor is advanced past it.
+     */
+    inline bool parse_unsigned(const char *&cursor, const char *end, uint64_t &value) noexcept {
+        skip_blanks(cursor, end);
+
+        if (cursor == end || static_cast<unsigned char>(*cursor - '0') > 9) {
+            return false;
+        }
+
+        uint64_t result = 0;
+
+        do {
+            const uint64_t digit = static_cast<unsigned char>(*cursor - '0');
+
+            //  Reject values not fitting into 64 bits
+            if (result > (UINT64_MAX - digit) / 10) {
+                return false;
+            }
+
+            result = result * 10 + digit;
+            ++cursor;
+        } while (cursor != end && static_cast<unsigned char>(*cursor - '0') <= 9);
+
+        if (cursor != end && !is_blank(*cursor)) {
+            return false;
+        }
+
+        value = result;
+
+        return true;
+    }
+
+    inline bool parse_pair(const std::string &line, uint64_t &first, uint64_t &second) noexcept {
+        const char *cursor = line.data();
+        const char *end = cursor + line.size();
+
+        return parse_unsigned(cursor, end, first) && parse_unsigned(cursor, end, second);
+    }
+
+    inline bool is_empty_line(const std::string &line) noexcept {
+        const char *cursor = line.data();
+        const char *end = cursor + line.size();
+
+        skip_blanks(cursor, end);
+
+        return cursor == end;
+    }
+}
+
+#endif
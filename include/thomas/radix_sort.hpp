@@ -0,0 +1,188 @@
+#ifndef THOMAS_RADIX_SORT_HPP
+#define THOMAS_RADIX_SORT_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+namespace thomas {
+    /**
+     pack_edge()
+     Key of a road ordering by source first and target second.
+     */
+    inline constexpr uint64_t pack_edge(const uint32_t source, const uint32_t target) noexcept {
+        return (static_cast<uint64_t>(source) << 32) | target;
+    }
+
+    inline constexpr uint32_t edge_source(const uint64_t key) noexcept {
+        return static_cast<uint32_t>(key >> 32);
+    }
+
+    inline constexpr uint32_t edge_target(const uint64_t key) noexcept {
+        return static_cast<uint32_t>(key);
+    }
+
+    /**
+     radix_sort()
+     Sorts the keys ascending with a least significant digit radix sort over
+     bytes. Digits which are the same for every key are skipped, so keys of a
+     few thousand shops take four passes rather than eight.
+
+     Each thread owns a contiguous range of the keys and a histogram per pass,
+     and the ranges are placed in order, so the sort is stable. Writes go
+     through a small buffer per bucket and are flushed a cache line at a time.
+
+     It pays off when the keys come unordered, as for network_diff. The
+     rows of csr_network::assign() come from a counting sort by shop, and
+     network::finalize() keeps sorting the connections of each shop on its
+     own: the lists are short and sort in cache, while a sort of every key
+     makes six passes over twice the roads.
+
+     @param keys The keys to sort, in place.
+     @param buffer Storage of the same size as the keys, reused in between calls.
+     @param threads Number of threads to use.
+     */
+    inline void radix_sort(std::vector<uint64_t> &keys, std::vector<uint64_t> &buffer, unsigned threads = std::thread::hardware_concurrency()) {
+        static constexpr size_t radix = 256;
+        static constexpr size_t digits = sizeof(uint64_t);
+        static constexpr size_t block = 64 / sizeof(uint64_t);
+
+        const size_t count = keys.size();
+
+        if (count < 2) {
+            return;
+        }
+
+        //  Small inputs don't pay for the threads
+        threads = count < 65536 ? 1u : std::max(1u, threads);
+
+        const size_t range = (count + threads - 1) / threads;
+
+        buffer.resize(count);
+
+        //  Histograms of every digit, thread major, then the write buffers
+        std::vector<size_t> counts(threads * digits * radix, 0);
+        std::vector<uint64_t> staging(threads * radix * block);
+        uint64_t *source = keys.data();
+        uint64_t *target = buffer.data();
+
+        const auto histogram = [&] (const unsigned t, const size_t d) {
+            return counts.data() + (t * digits + d) * radix;
+        };
+
+        const auto run = [&] (auto &&step) {
+            std::vector<std::thread> workers;
+
+            if (threads > 1) {
+                workers.reserve(threads - 1);
+            }
+
+            for (unsigned t = 1; t < threads; ++t) {
+                workers.emplace_back(step, t);
+            }
+
+            step(0u);
+
+            for (auto &worker : workers) {
+                worker.join();
+            }
+        };
+
+        //  Every digit is counted at once, to find the ones to skip
+        run([&] (const unsigned t) {
+            const size_t end = std::min(count, (t + 1) * range);
+
+            for (size_t i = t * range; i < end; ++i) {
+                const uint64_t key = source[i];
+
+                for (size_t d = 0; d < digits; ++d) {
+                    ++histogram(t, d)[(key >> (8 * d)) & 0xff];
+                }
+            }
+        });
+
+        const auto is_constant = [&] (const size_t d) {
+            const size_t b = (source[0] >> (8 * d)) & 0xff;
+            size_t total = 0;
+
+            for (unsigned t = 0; t < threads; ++t) {
+                total += histogram(t, d)[b];
+            }
+
+            return total == count;
+        };
+
+        bool counted = true;
+
+        for (size_t d = 0; d < digits; ++d) {
+            if (is_constant(d)) {
+                continue;
+            }
+
+            //  The keys moved since the first count, so later digits are counted again
+            if (!counted) {
+                run([&] (const unsigned t) {
+                    size_t *each = histogram(t, d);
+                    const size_t end = std::min(count, (t + 1) * range);
+
+                    std::fill(each, each + radix, 0);
+
+                    for (size_t i = t * range; i < end; ++i) {
+                        ++each[(source[i] >> (8 * d)) & 0xff];
+                    }
+                });
+            }
+
+            counted = false;
+
+            //  Exclusive prefix sum, bucket major so that the ranges stay in order
+            size_t offset = 0;
+
+            for (size_t b = 0; b < radix; ++b) {
+                for (unsigned t = 0; t < threads; ++t) {
+                    const size_t bucket = histogram(t, d)[b];
+
+                    histogram(t, d)[b] = offset;
+                    offset += bucket;
+                }
+            }
+
+            run([&] (const unsigned t) {
+                size_t *positions = histogram(t, d);
+                uint64_t *pending = staging.data() + t * radix * block;
+                std::array<uint8_t, radix> filled = {};
+                const size_t end = std::min(count, (t + 1) * range);
+
+                for (size_t i = t * range; i < end; ++i) {
+                    const uint64_t key = source[i];
+                    const size_t b = (key >> (8 * d)) & 0xff;
+
+                    pending[b * block + filled[b]] = key;
+
+                    if (++filled[b] == block) {
+                        std::memcpy(target + positions[b], pending + b * block, block * sizeof(uint64_t));
+                        positions[b] += block;
+                        filled[b] = 0;
+                    }
+                }
+
+                for (size_t b = 0; b < radix; ++b) {
+                    std::memcpy(target + positions[b], pending + b * block, filled[b] * sizeof(uint64_t));
+                    positions[b] += filled[b];
+                }
+            });
+
+            std::swap(source, target);
+        }
+
+        if (source != keys.data()) {
+            keys.swap(buffer);
+        }
+    }
+}
+
+#endif
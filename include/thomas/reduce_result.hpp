@@ -0,0 +1,35 @@
+#ifndef THOMAS_REDUCE_RESULT_HPP
+#define THOMAS_REDUCE_RESULT_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace thomas {
+    /**
+     reduce_result
+     Outcome of a reduction step, with the shops which tied at the required
+     impact as indices of the network. The span refers to the workspace of
+     the reduction, and stays valid until the workspace is reduced again.
+     */
+    struct reduce_result {
+        uint64_t threshold = 0;
+        uint64_t required_impact = 0;
+
+        //  Shops with the threshold degree and the required impact
+        uint64_t count = 0;
+        std::span<const size_t> shops;
+
+        /**
+         disposed()
+         The number of nodes disposed, as returned by network::reduce().
+
+         @return The number of nodes disposed.
+         */
+        inline uint64_t disposed() const noexcept {
+            return count < 2 ? 0 : count;
+        }
+    };
+}
+
+#endif
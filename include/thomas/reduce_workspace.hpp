@@ -0,0 +1,56 @@
+#ifndef THOMAS_REDUCE_WORKSPACE_HPP
+#define THOMAS_REDUCE_WORKSPACE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "thomas/shop.hpp"
+
+namespace thomas {
+    /**
+     reduce_workspace
+     Temporaries of network::reduce(), kept in between calls. Buffers are only
+     cleared, so once they have grown to the size of the network, repeated
+     reductions don't allocate. Growths are counted to make that observable.
+     */
+    class reduce_workspace {
+    private:
+        uint64_t growths = 0;
+
+    public:
+        std::vector<shop *> linear_shops;
+
+        //  Degree histograms of network::order_by_degree(), one per thread
+        std::vector<size_t> counts;
+        std::vector<uint64_t> impacts;
+
+        //  Shops of the last reduce_result
+        std::vector<size_t> disposed;
+
+        inline size_t capacity_bytes() const noexcept {
+            return linear_shops.capacity() * sizeof(shop *)
+                 + counts.capacity() * sizeof(size_t)
+                 + impacts.capacity() * sizeof(uint64_t)
+                 + disposed.capacity() * sizeof(size_t);
+        }
+
+        /**
+         get_growths()
+         The number of reductions which had to allocate. Reducing the same
+         network repeatedly only allocates on the first call, and not at all
+         once it is finalized with an adjacency matrix, which keeps its own.
+
+         @return The number of growths.
+         */
+        inline uint64_t get_growths() const noexcept {
+            return growths;
+        }
+
+        inline void note_growth(const size_t previous_capacity) noexcept {
+            growths += capacity_bytes() > previous_capacity;
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,40 @@
+#ifndef THOMAS_SHOP_HPP
+#define THOMAS_SHOP_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace thomas {
+    class shop {
+    private:
+        uint64_t identifier;
+        std::vector<shop *> connected_shops;
+
+        //  Position in the registration order of the owning network
+        size_t index = 0;
+
+    public:
+        explicit shop(const uint64_t identifier) : identifier(identifier) {
+            //  Empty implementation
+        }
+
+        inline std::vector<shop *> &get_connected_shops() noexcept {
+            return connected_shops;
+        }
+
+        inline const uint64_t get_identifier() const noexcept {
+            return identifier;
+        }
+
+        inline size_t get_index() const noexcept {
+            return index;
+        }
+
+        inline void set_index(const size_t new_index) noexcept {
+            index = new_index;
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,243 @@
+#ifndef THOMAS_SMALL_NETWORK_HPP
+#define THOMAS_SMALL_NETWORK_HPP
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace thomas {
+    /**
+     small_network
+     Network with its capacity fixed at compile time, for the assignment sized
+     inputs. Everything is kept in std::array members, so an instance declared
+     as a local variable never allocates, and every method can be evaluated at
+     compile time. Roads are kept as a list of dense index pairs, the degrees
+     count parallel roads as thomas::network does, and the adjacency bitset
+     answers has_edge() in constant time.
+
+     The adjacency bitset takes Shops * Shops / 8 bytes, about 125 KiB of the
+     145 KiB of a small_network<1000, 1000>, so the assignment sized network
+     fits on a default thread stack; capacities of several thousand shops
+     belong in static storage or on the heap.
+     */
+    template <size_t Shops, size_t Roads = Shops>
+    class small_network {
+        static_assert(Shops >= 1 && Shops < UINT32_MAX, "capacity should fit into 32 bits");
+
+    public:
+        using index_type = std::conditional_t<(Shops < UINT16_MAX), uint16_t, uint32_t>;
+
+        static constexpr index_type npos = static_cast<index_type>(-1);
+
+    private:
+        static constexpr size_t words = (Shops + 63) / 64;
+
+        //  Open addressing table of index + 1, with zero marking an empty slot
+        static constexpr size_t slots = std::bit_ceil(2 * Shops);
+
+        std::array<uint64_t, Shops> identifiers{};
+        std::array<uint32_t, Shops> degrees{};
+        std::array<std::array<index_type, 2>, Roads> roads{};
+        std::array<std::array<uint64_t, words>, Shops> adjacency{};
+        std::array<index_type, slots> table{};
+
+        size_t num_shops = 0;
+        size_t num_roads = 0;
+
+        static constexpr size_t slot_of(const uint64_t identifier) noexcept {
+            //  Fibonacci hashing
+            return static_cast<size_t>((identifier * 0x9E3779B97F4A7C15ull) >> 32) & (slots - 1);
+        }
+
+        static constexpr bool test(const std::array<uint64_t, words> &bits, const size_t i) noexcept {
+            return (bits[i / 64] >> (i % 64)) & 1;
+        }
+
+    public:
+        constexpr small_network() = default;
+
+        static constexpr size_t shop_capacity() noexcept {
+            return Shops;
+        }
+
+        static constexpr size_t road_capacity() noexcept {
+            return Roads;
+        }
+
+        constexpr size_t number_of_shops() const noexcept {
+            return num_shops;
+        }
+
+        constexpr size_t number_of_roads() const noexcept {
+            return num_roads;
+        }
+
+        constexpr uint64_t identifier_at(const index_type i) const noexcept {
+            return identifiers[i];
+        }
+
+        constexpr uint32_t degree_at(const index_type i) const noexcept {
+            return degrees[i];
+        }
+
+        /**
+         find()
+         Looks up the dense index of the shop with the given identifier.
+
+         @return The index of the shop, npos when missing.
+         */
+        constexpr index_type find(const uint64_t identifier) const noexcept {
+            for (size_t slot = slot_of(identifier); table[slot] != 0; slot = (slot + 1) & (slots - 1)) {
+                if (identifiers[table[slot] - 1] == identifier) {
+                    return static_cast<index_type>(table[slot] - 1);
+                }
+            }
+
+            return npos;
+        }
+
+        /**
+         find_or_register()
+         Looks up the shop with the given identifier, registering it when missing.
+
+         @return The index of the shop, npos when the shop capacity is exhausted.
+         */
+        constexpr index_type find_or_register(const uint64_t identifier) noexcept {
+            size_t slot = slot_of(identifier);
+
+            for (; table[slot] != 0; slot = (slot + 1) & (slots - 1)) {
+                if (identifiers[table[slot] - 1] == identifier) {
+                    return static_cast<index_type>(table[slot] - 1);
+                }
+            }
+
+            if (num_shops == Shops) {
+                return npos;
+            }
+
+            identifiers[num_shops] = identifier;
+            table[slot] = static_cast<index_type>(num_shops + 1);
+
+            return static_cast<index_type>(num_shops++);
+        }
+
+        /**
+         connect()
+         Adds a road in between two shops, registering the shops when missing.
+
+         @return Whether the road fits into the capacity, the network is left
+                 unchanged otherwise.
+         */
+        constexpr bool connect(const uint64_t from, const uint64_t to) noexcept {
+            if (num_roads == Roads) {
+                return false;
+            }
+
+            //  Near the shop capacity, both ends should fit before either is registered
+            if (num_shops + 2 > Shops) {
+                const size_t missing = size_t(find(from) == npos) + size_t(to != from && find(to) == npos);
+
+                if (num_shops + missing > Shops) {
+                    return false;
+                }
+            }
+
+            const index_type source = find_or_register(from);
+            const index_type destination = find_or_register(to);
+
+            roads[num_roads++] = { source, destination };
+            degrees[source] += 1;
+            degrees[destination] += 1;
+            adjacency[source][destination / 64] |= uint64_t(1) << (destination % 64);
+            adjacency[destination][source / 64] |= uint64_t(1) << (source % 64);
+
+            return true;
+        }
+
+        constexpr bool has_edge(const index_type a, const index_type b) const noexcept {
+            return test(adjacency[a], b);
+        }
+
+        /**
+         clear()
+         Empties the network for reuse. The degrees and adjacency rows are only
+         reset for the shops in use, while the lookup table, a few bytes per
+         shop of capacity, is reset whole.
+         */
+        constexpr void clear() noexcept {
+            for (size_t i = 0; i < num_shops; ++i) {
+                degrees[i] = 0;
+                adjacency[i] = {};
+            }
+
+            table = {};
+            num_shops = 0;
+            num_roads = 0;
+        }
+
+        /**
+         reduce()
+         Same reduction as network::reduce(). The shops at the highest degree are
+         kept in a bitset, and their impacts are gathered in one pass over the roads.
+
+         @return The number of nodes disposed.
+         */
+        constexpr uint64_t reduce() const noexcept {
+            if (num_shops == 0) {
+                return 0;
+            }
+
+            uint32_t threshold = 0;
+
+            for (size_t i = 0; i < num_shops; ++i) {
+                threshold = degrees[i] > threshold ? degrees[i] : threshold;
+            }
+
+            std::array<uint64_t, words> tied{};
+
+            for (size_t i = 0; i < num_shops; ++i) {
+                tied[i / 64] |= uint64_t(degrees[i] == threshold) << (i % 64);
+            }
+
+            //  Only the roads leaving the tie set contribute to an impact
+            std::array<uint64_t, Shops> impacts{};
+
+            for (size_t i = 0; i < num_roads; ++i) {
+                const index_type source = roads[i][0];
+                const index_type destination = roads[i][1];
+                const bool source_tied = test(tied, source);
+                const bool destination_tied = test(tied, destination);
+
+                if (source_tied && !destination_tied) {
+                    impacts[source] += degrees[destination];
+                } else if (destination_tied && !source_tied) {
+                    impacts[destination] += degrees[source];
+                }
+            }
+
+            uint64_t required_impact = 0;
+
+            for (size_t w = 0; w < words; ++w) {
+                for (uint64_t bits = tied[w]; bits != 0; bits &= bits - 1) {
+                    const size_t i = w * 64 + static_cast<size_t>(std::countr_zero(bits));
+                    required_impact = impacts[i] > required_impact ? impacts[i] : required_impact;
+                }
+            }
+
+            uint64_t count = 0;
+
+            for (size_t w = 0; w < words; ++w) {
+                for (uint64_t bits = tied[w]; bits != 0; bits &= bits - 1) {
+                    count += impacts[w * 64 + static_cast<size_t>(std::countr_zero(bits))] == required_impact;
+                }
+            }
+
+            //  If the number of elements remaining is lower than two, no further action is required
+            return count < 2 ? 0 : count;
+        }
+    };
+}
+
+#endif
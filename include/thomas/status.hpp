@@ -0,0 +1,156 @@
+#ifndef THOMAS_STATUS_HPP
+#define THOMAS_STATUS_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <iostream>
+
+namespace thomas {
+    enum class status : int32_t {
+        ok = 0,
+        argument_error = 1,
+        io_error = 2,
+        parse_error = 3,
+        range_error = 4,
+        too_many_errors = 5
+    };
+
+    inline const char *describe(const status status) noexcept {
+        switch (status) {
+            case status::ok:
+                return "ok";
+            case status::argument_error:
+                return "argument error";
+            case status::io_error:
+                return "io error";
+            case status::parse_error:
+                return "parsing error";
+            case status::range_error:
+                return "range error";
+            case status::too_many_errors:
+                return "too many errors";
+        }
+
+        return "unknown error";
+    }
+
+    enum class error_policy {
+        abort,
+        skip
+    };
+
+    /**
+     error_buffer
+     Collects the malformed lines met while loading. Only the first few are
+     kept with their messages, the rest are only counted. Depending on the
+     policy, the loader either stops at the first error or skips the line
+     until the error limit is exceeded.
+     */
+    class error_buffer {
+    public:
+        struct entry {
+            uint64_t line;
+            thomas::status status;
+            bool warning;
+            std::string message;
+        };
+
+    private:
+        error_policy policy;
+        size_t capacity;
+        uint64_t max_errors;
+
+        std::vector<entry> entries;
+        uint64_t errors = 0;
+        uint64_t warnings = 0;
+        thomas::status last = status::ok;
+
+        inline void record(const uint64_t line, const thomas::status status, const bool warning, std::string &&message) {
+            if (entries.size() < capacity) {
+                entries.push_back({ line, status, warning, std::move(message) });
+            }
+        }
+
+    public:
+        explicit error_buffer(const error_policy policy = error_policy::abort,
+                              const size_t capacity = 16,
+                              const uint64_t max_errors = UINT64_MAX)
+            : policy(policy), capacity(capacity), max_errors(max_errors) {
+            entries.reserve(capacity);
+        }
+
+        /**
+         report()
+         Records an error at the given line, line zero refers to the whole input.
+
+         @return Whether the loader should skip the line and carry on.
+         */
+        inline bool report(const uint64_t line, const thomas::status status, std::string message) {
+            ++errors;
+            last = status;
+            record(line, status, false, std::move(message));
+
+            return policy == error_policy::skip && errors <= max_errors;
+        }
+
+        /**
+         warn()
+         Records a recoverable issue, which never stops the loader.
+         */
+        inline void warn(const uint64_t line, const thomas::status status, std::string message) {
+            ++warnings;
+            record(line, status, true, std::move(message));
+        }
+
+        /**
+         stopped()
+         The status to return when report() asked to stop.
+
+         @return The status of the last error, or too_many_errors when the limit is exceeded.
+         */
+        inline thomas::status stopped() const noexcept {
+            if (policy == error_policy::skip && errors > max_errors) {
+                return status::too_many_errors;
+            }
+
+            return last;
+        }
+
+        inline const std::vector<entry> &get_entries() const noexcept {
+            return entries;
+        }
+
+        inline uint64_t get_errors() const noexcept {
+            return errors;
+        }
+
+        inline uint64_t get_warnings() const noexcept {
+            return warnings;
+        }
+
+        inline uint64_t get_dropped() const noexcept {
+            return errors + warnings - entries.size();
+        }
+    };
+
+    inline std::ostream &operator<<(std::ostream &os, const error_buffer &errors) {
+        for (auto &each_entry : errors.get_entries()) {
+            os << (each_entry.warning ? "warning" : describe(each_entry.status)) << ": ";
+
+            if (each_entry.line != 0) {
+                os << "line " << each_entry.line << ": ";
+            }
+
+            os << each_entry.message << std::endl;
+        }
+
+        if (errors.get_dropped() != 0) {
+            os << "... " << errors.get_dropped() << " more not shown" << std::endl;
+        }
+
+        return os;
+    }
+}
+
+#endif
@@ -0,0 +1,274 @@
+#ifndef THOMAS_TEMPORAL_NETWORK_HPP
+#define THOMAS_TEMPORAL_NETWORK_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <span>
+#include <vector>
+
+#include "thomas/identifier_map.hpp"
+#include "thomas/reduce_result.hpp"
+
+namespace thomas {
+    /**
+     temporal_network
+     Roads with timestamps, of which only the ones within the last window
+     of time are kept. Roads are added in time order into a ring of
+     batches, and expired from the oldest batch on, a whole batch being
+     released at once.
+
+     Degrees are updated as roads enter and expire. Shops are bucketed by
+     degree, and since a degree only moves by one, the maximum is kept in
+     constant time, so reduce() only visits the shops at the threshold. The
+     connections of a shop expire in the order they were added, so each
+     connection list is a queue. Shops are indexed with 32 bits.
+     */
+    class temporal_network {
+    private:
+        struct _road {
+            uint64_t timestamp;
+            uint32_t from;
+            uint32_t to;
+        };
+
+        struct _batch {
+            std::vector<_road> roads;
+            size_t expired = 0;
+        };
+
+        struct _connections {
+            std::vector<uint32_t> shops;
+            size_t expired = 0;
+        };
+
+        uint64_t window;
+        size_t batch_size;
+        uint64_t latest = 0;
+
+        std::deque<_batch> batches;
+        size_t num_roads = 0;
+
+        identifier_map identifiers;
+        std::vector<uint64_t> shop_identifiers;
+        std::vector<_connections> connections;
+
+        //  Shops by degree, with the position of each shop in its bucket
+        std::vector<std::vector<uint32_t>> buckets;
+        std::vector<size_t> positions;
+        uint64_t max_degree = 0;
+
+        std::vector<uint64_t> impacts;
+        std::vector<size_t> disposed;
+
+        inline void move(const uint32_t shop, const uint64_t from, const uint64_t to) {
+            std::vector<uint32_t> &source = buckets[from];
+
+            //  Swap removal, the last shop of the bucket takes the place
+            positions[source.back()] = positions[shop];
+            source[positions[shop]] = source.back();
+            source.pop_back();
+
+            if (buckets.size() <= to) {
+                buckets.resize(to + 1);
+            }
+
+            positions[shop] = buckets[to].size();
+            buckets[to].push_back(shop);
+        }
+
+        inline void attach(const uint32_t shop, const uint32_t neighbor) {
+            const uint64_t degree = this->degree(shop);
+
+            connections[shop].shops.push_back(neighbor);
+            move(shop, degree, degree + 1);
+            max_degree = std::max(max_degree, degree + 1);
+        }
+
+        inline void detach(const uint32_t shop) {
+            _connections &list = connections[shop];
+            const uint64_t degree = this->degree(shop);
+
+            //  The oldest connection is the one expiring
+            if (++list.expired * 2 >= list.shops.size()) {
+                list.shops.erase(list.shops.begin(), list.shops.begin() + static_cast<std::ptrdiff_t>(list.expired));
+                list.expired = 0;
+            }
+
+            move(shop, degree, degree - 1);
+
+            while (max_degree != 0 && buckets[max_degree].empty()) {
+                --max_degree;
+            }
+        }
+
+        inline uint32_t find_or_register(const uint64_t identifier) {
+            const size_t index = identifiers.insert(identifier, shop_identifiers.size());
+
+            if (index == shop_identifiers.size()) {
+                shop_identifiers.push_back(identifier);
+                connections.emplace_back();
+                positions.push_back(buckets[0].size());
+                buckets[0].push_back(static_cast<uint32_t>(index));
+            }
+
+            return static_cast<uint32_t>(index);
+        }
+
+    public:
+        /**
+         temporal_network()
+
+         @param window Length of the window, in the unit of the timestamps.
+         @param batch_size Roads per batch of the ring.
+         */
+        explicit temporal_network(const uint64_t window, const size_t batch_size = 4096)
+            : window(window), batch_size(std::max<size_t>(batch_size, 1)), buckets(1) {
+            //  Empty implementation
+        }
+
+        inline size_t number_of_shops() const noexcept {
+            return shop_identifiers.size();
+        }
+
+        inline size_t number_of_roads() const noexcept {
+            return num_roads;
+        }
+
+        inline uint64_t identifier_at(const size_t i) const noexcept {
+            return shop_identifiers[i];
+        }
+
+        inline uint64_t degree(const size_t i) const noexcept {
+            return connections[i].shops.size() - connections[i].expired;
+        }
+
+        inline uint64_t get_max_degree() const noexcept {
+            return max_degree;
+        }
+
+        inline std::span<const uint32_t> neighbors(const size_t i) const noexcept {
+            const _connections &list = connections[i];
+
+            return std::span<const uint32_t>(list.shops.data() + list.expired, list.shops.size() - list.expired);
+        }
+
+        /**
+         add()
+         Adds a road at the given time, expiring the roads which fall out of the
+         window. Timestamps shouldn't decrease.
+
+         @return Whether the road was added, false when it is older than the last one.
+         */
+        inline bool add(const uint64_t timestamp, const uint64_t from, const uint64_t to) {
+            if (timestamp < latest) {
+                return false;
+            }
+
+            advance(timestamp);
+
+            const uint32_t source = find_or_register(from);
+            const uint32_t destination = find_or_register(to);
+
+            if (batches.empty() || batches.back().roads.size() == batch_size) {
+                batches.emplace_back();
+                batches.back().roads.reserve(batch_size);
+            }
+
+            batches.back().roads.push_back({ timestamp, source, destination });
+            ++num_roads;
+
+            //  Same order of connections as network::connect()
+            attach(destination, source);
+            attach(source, destination);
+
+            return true;
+        }
+
+        /**
+         advance()
+         Moves the window to end at the given time, expiring every road with a
+         timestamp at or before now - window.
+         */
+        inline void advance(const uint64_t now) {
+            latest = std::max(latest, now);
+
+            if (latest < window) {
+                return;
+            }
+
+            const uint64_t horizon = latest - window;
+
+            while (!batches.empty()) {
+                _batch &oldest = batches.front();
+
+                while (oldest.expired < oldest.roads.size() && oldest.roads[oldest.expired].timestamp <= horizon) {
+                    const _road &road = oldest.roads[oldest.expired++];
+
+                    detach(road.to);
+                    detach(road.from);
+                    --num_roads;
+                }
+
+                if (oldest.expired < oldest.roads.size()) {
+                    return;
+                }
+
+                batches.pop_front();
+            }
+        }
+
+        /**
+         analyze()
+         Same reduction as network::analyze() over the roads of the window. Only
+         the shops at the threshold and their neighbors are visited. The span of
+         the result stays valid until the next call.
+
+         @return The result of the reduction.
+         */
+        inline reduce_result analyze() {
+            reduce_result result;
+
+            impacts.clear();
+            disposed.clear();
+            result.threshold = max_degree;
+
+            if (max_degree == 0) {
+                return result;
+            }
+
+            for (auto &shop : buckets[max_degree]) {
+                uint64_t impact = 0;
+
+                for (auto &each : neighbors(shop)) {
+                    const uint64_t degree = this->degree(each);
+                    impact += degree < max_degree ? degree : 0;
+                }
+
+                impacts.push_back(impact);
+                result.required_impact = std::max(result.required_impact, impact);
+            }
+
+            for (size_t k = 0; k < impacts.size(); ++k) {
+                if (impacts[k] == result.required_impact) {
+                    disposed.push_back(buckets[max_degree][k]);
+                }
+            }
+
+            //  Buckets aren't ordered, the shops are reported by index
+            std::sort(disposed.begin(), disposed.end());
+
+            result.count = disposed.size();
+            result.shops = std::span<const size_t>(disposed.data(), disposed.size());
+
+            return result;
+        }
+
+        inline uint64_t reduce() {
+            return analyze().disposed();
+        }
+    };
+}
+
+#endif
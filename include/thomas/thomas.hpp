@@ -0,0 +1,30 @@
+#ifndef THOMAS_THOMAS_HPP
+#define THOMAS_THOMAS_HPP
+
+#include "thomas/config.hpp"
+#include "thomas/shop.hpp"
+#include "thomas/neighbors.hpp"
+#include "thomas/dense_network.hpp"
+#include "thomas/reduce_result.hpp"
+#include "thomas/reduce_workspace.hpp"
+#include "thomas/identifier_map.hpp"
+#include "thomas/intersect.hpp"
+#include "thomas/graph_backend.hpp"
+#include "thomas/edge_list.hpp"
+#include "thomas/heavy_hitters.hpp"
+#include "thomas/network.hpp"
+#include "thomas/radix_sort.hpp"
+#include "thomas/csr_network.hpp"
+#include "thomas/edge_stream.hpp"
+#include "thomas/bsp_engine.hpp"
+#include "thomas/temporal_network.hpp"
+#include "thomas/network_diff.hpp"
+#include "thomas/small_network.hpp"
+#include "thomas/graph_batch.hpp"
+#include "thomas/parse.hpp"
+#include "thomas/status.hpp"
+#include "thomas/input.hpp"
+#include "thomas/loader.hpp"
+#include "thomas/arrow.hpp"
+
+#endif
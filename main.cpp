@@ -1,287 +1,202 @@
-#include <iostream>
 #include <cstdint>
-#include <memory>
+#include <cstring>
+#include <iostream>
+#include <string>
 #include <vector>
-#include <fstream>
-#include <map>
-#include <algorithm>
-#include <iterator>
-
-#undef ENABLE_DEBUG
-
-//  Clang __unused-compat polyfill
-#ifndef __unused
-#define __unused
-#endif
-
-#ifdef ENABLE_DEBUG
-#define DEBUG_STREAM std::cout
-#else
-std::ofstream null_stream("/dev/null");
-#define DEBUG_STREAM null_stream
-#endif
-
-namespace thomas {
-    class shop {
-    private:
-        uint64_t identifier;
-        std::vector<shop *> connected_shops;
-
-    public:
-        explicit shop(const uint64_t identifier) : identifier(identifier) {
-            //  Empty implementation
-        }
-
-        inline std::vector<shop *> &get_connected_shops() noexcept {
-            return connected_shops;
-        }
-
-        inline const uint64_t get_identifier() const noexcept {
-            return identifier;
-        }
-    };
 
-    class network {
-    private:
-        struct _impact_entry {
-            uint64_t impact;
-        };
+#include "thomas/thomas.hpp"
 
-        std::map<uint64_t, thomas::shop *> shops;
+inline bool parse_option(const std::string &argument, const char *name, uint64_t &value) {
+    const char *cursor = argument.data() + std::strlen(name);
+    const char *end = argument.data() + argument.size();
 
-        inline std::map<uint64_t, thomas::shop *> &get_shops() noexcept {
-            return shops;
-        }
-
-    public:
-        explicit network() {
-            shops = std::map<uint64_t, thomas::shop *>();
-        }
-
-        virtual ~network() {
-            for (auto &each_pair : shops) {
-                delete each_pair.second;
-            }
-
-            shops.clear();
-        }
+    return thomas::parse_unsigned(cursor, end, value) && cursor == end;
+}
 
-        inline shop *shop_at(const uint64_t i) {
-            return get_shops().at(i);
-        }
+template <typename Network>
+inline thomas::status load(const char *path, const thomas::format format, const thomas::header_mode header, const uint64_t max_reservation,
+                           Network &network, thomas::error_buffer &errors) {
+    thomas::input input_file(path);
 
-        inline void register_shop(shop *shop) {
-            shops.insert(std::make_pair(shop->get_identifier(), shop));
-        }
+    if (!input_file.is_open()) {
+        std::cerr << "io error: file couldn't be opened" << std::endl;
+        return thomas::status::io_error;
+    }
 
-        inline uint64_t number_of_connections() noexcept {
-            uint64_t counter = 0;
+    if (input_file.has_failed()) {
+        std::cerr << "io error: " << input_file.get_error() << std::endl;
+        return thomas::status::io_error;
+    }
 
-            for (auto &each_pair : get_shops()) {
-                shop *shop = each_pair.second;
+    return thomas::import(format, input_file, network, errors, header, max_reservation);
+}
 
-                for (auto &remote_shop : shop->get_connected_shops()) {
-                    (void)remote_shop;
-                    counter += 1;
-                }
+int32_t main(int32_t argc, const char * argv[]) {
+    const char *path = nullptr;
+    std::string edges_path, shops_path;
+    bool has_format = false;
+    thomas::format format = thomas::format::native;
+    thomas::error_policy policy = thomas::error_policy::abort;
+    thomas::header_mode header = thomas::header_mode::trust;
+    uint64_t max_errors = UINT64_MAX, buffer_size = 16, approximate = 0;
+    uint64_t max_reservation = thomas::default_max_reservation;
+
+    for (int32_t i = 1; i < argc; ++i) {
+        const std::string argument = argv[i];
+
+        if (argument.compare(0, 9, "--format=") == 0) {
+            if (!thomas::format_from_name(argument.substr(9), format)) {
+                std::cerr << "argument error: unknown format \"" << argument.substr(9) << "\", expected native, metis, mtx, snap or arrow" << std::endl;
+                return static_cast<int32_t>(thomas::status::argument_error);
             }
 
-            return counter;
-        }
-
-        /**
-         reduce()
-         Reduces the network one step down by disposing nodes to two subtle parts.
-
-         @return The number of nodes disposed.
-         */
-        inline uint64_t reduce() noexcept {
-            std::vector<shop *> linear_shops;
-            std::map<uint64_t, shop *> *shops = &get_shops();
-
-            linear_shops.reserve(shops->size());
-
-            std::for_each(shops->begin(),
-                          shops->end(),
-                          [&linear_shops] (const std::map<uint64_t, shop *>::value_type& pair) {
-                linear_shops.push_back(pair.second);
-            });
-
-            //  Sort the linear container with number of connections
-            std::sort(linear_shops.begin(),
-                      linear_shops.end(),
-                      [] (shop *lhs, shop *rhs) {
-                return lhs->get_connected_shops().size() > rhs->get_connected_shops().size();
-            });
-
-            const uint64_t threshold = linear_shops.front()->get_connected_shops().size();
-
-            DEBUG_STREAM << "reducing with threshold value of " << threshold << std::endl;
-
-            //  Filter out the elements with connection size lower than threshold value
-            linear_shops.erase(std::remove_if(linear_shops.begin(),
-                                              linear_shops.end(),
-                                              [&threshold] (shop *el) {
-                return el->get_connected_shops().size() < threshold;
-            }), linear_shops.end());
-
-            std::vector<_impact_entry> impacts;
-            impacts.reserve(linear_shops.size());
-
-            //  Find the external impact of each node
-            std::for_each(linear_shops.begin(),
-                          linear_shops.end(),
-                          [&impacts,
-                           &linear_shops] (shop *el) {
-                uint64_t impact = 0;
-
-                for (auto &each_connection : el->get_connected_shops()) {
-                    //  Check whether the connection is external
-                    if (std::find(linear_shops.begin(), linear_shops.end(), each_connection) == linear_shops.end()) {
-                        impact += each_connection->get_connected_shops().size();
-                    }
-                }
-
-                impacts.push_back({
-                    impact
-                });
-            });
-
-            //  Sort the array with impact values descending
-            std::sort(impacts.begin(),
-                      impacts.end(),
-                      [] (_impact_entry lhs,
-                          _impact_entry rhs) {
-                return lhs.impact > rhs.impact;
-            });
-
-            const uint64_t required_impact = impacts.front().impact;
-
-            //  Filter out the elements with impact lower than required
-            impacts.erase(std::remove_if(impacts.begin(),
-                                         impacts.end(),
-                                         [&required_impact /* clang-capture-default */] (_impact_entry el) {
-                 return el.impact < required_impact;
-             }), impacts.end());
-
-            //  If the number of elements remaining is lower than two, no further action is required
-            if (impacts.size() < 2) {
-                return 0;
+            has_format = true;
+        } else if (argument.compare(0, 9, "--header=") == 0) {
+            if (!thomas::header_mode_from_name(argument.substr(9), header)) {
+                std::cerr << "argument error: unknown header mode \"" << argument.substr(9) << "\", expected trust, verify, ignore or none" << std::endl;
+                return static_cast<int32_t>(thomas::status::argument_error);
+            }
+        } else if (argument == "--on-error=abort") {
+            policy = thomas::error_policy::abort;
+        } else if (argument == "--on-error=skip") {
+            policy = thomas::error_policy::skip;
+        } else if (argument.compare(0, 13, "--max-errors=") == 0) {
+            if (!parse_option(argument, "--max-errors=", max_errors)) {
+                std::cerr << "argument error: invalid error limit \"" << argument.substr(13) << "\"" << std::endl;
+                return static_cast<int32_t>(thomas::status::argument_error);
             }
 
-            return impacts.size();
-        }
-
-        friend std::ostream &operator<<(std::ostream &os, network &network);
-    };
-
-    std::ostream &operator<< (std::ostream &os, network &network) {
-        for (auto &each_pair : network.get_shops()) {
-            shop *shop = each_pair.second;
-
-            for (auto &remote_shop : shop->get_connected_shops()) {
-                os << shop->get_identifier()  << " is connected with " << remote_shop->get_identifier() << std::endl;
+            policy = thomas::error_policy::skip;
+        } else if (argument.compare(0, 15, "--error-buffer=") == 0) {
+            if (!parse_option(argument, "--error-buffer=", buffer_size)) {
+                std::cerr << "argument error: invalid error buffer size \"" << argument.substr(15) << "\"" << std::endl;
+                return static_cast<int32_t>(thomas::status::argument_error);
             }
+        } else if (argument.compare(0, 18, "--max-reservation=") == 0) {
+            if (!parse_option(argument, "--max-reservation=", max_reservation)) {
+                std::cerr << "argument error: invalid reservation bound \"" << argument.substr(18) << "\"" << std::endl;
+                return static_cast<int32_t>(thomas::status::argument_error);
+            }
+        } else if (argument.compare(0, 14, "--approximate=") == 0) {
+            if (!parse_option(argument, "--approximate=", approximate) || approximate == 0) {
+                std::cerr << "argument error: invalid number of candidates \"" << argument.substr(14) << "\"" << std::endl;
+                return static_cast<int32_t>(thomas::status::argument_error);
+            }
+        } else if (argument.compare(0, 15, "--export-edges=") == 0) {
+            edges_path = argument.substr(15);
+        } else if (argument.compare(0, 15, "--export-shops=") == 0) {
+            shops_path = argument.substr(15);
+        } else if (path == nullptr) {
+            path = argv[i];
+        } else {
+            std::cerr << "argument error: unexpected argument \"" << argument << "\"" << std::endl;
+            return static_cast<int32_t>(thomas::status::argument_error);
         }
-
-        return os;
     }
-}
 
-int32_t main(int32_t argc, const char * argv[]) {
-    if (argc != 2) {
+    if (path == nullptr) {
         std::cerr << "argument error: missing file argument" << std::endl;
-        std::terminate();
+        return static_cast<int32_t>(thomas::status::argument_error);
     }
 
-    std::ifstream input_file(argv[1]);
-
-    if (!input_file.is_open()) {
-        std::cerr << "io error: file couldn't be opened" << std::endl;
-        std::terminate();
+    if (!has_format) {
+        format = thomas::format_from_path(path);
     }
 
-    std::string buffer_str;
-    uint64_t num_shops, num_roads;
+    thomas::error_buffer errors(policy, static_cast<size_t>(buffer_size), max_errors);
+    thomas::status status;
 
-    //  Fetch the number of shops and roads
-    std::getline(input_file, buffer_str);
+    //  Streams the input once per pass, keeping the top degrees only
+    if (approximate != 0) {
+        if (format == thomas::format::arrow || header == thomas::header_mode::verify || !edges_path.empty() || !shops_path.empty()) {
+            std::cerr << "argument error: approximate reduction needs a text input without header verification or exports" << std::endl;
+            return static_cast<int32_t>(thomas::status::argument_error);
+        }
 
-    if (std::sscanf(buffer_str.data(), "%lu %lu", &num_shops, &num_roads) != 2) {
-        std::cerr << "parsing error: couldn't parse header" << std::endl;
-        std::terminate();
-    }
+        thomas::heavy_hitters sketch(static_cast<size_t>(approximate));
 
-    if (num_shops < 2 || num_shops > 1000) {
-        std::cerr << "argument error: number of shops should be in between 2 to 1000 inclusive" << std::endl;
-        std::terminate();
-    }
+        status = load(path, format, header, max_reservation, sketch, errors);
+        std::cerr << errors;
 
-    if (num_roads < 1 || num_roads > 1000) {
-        std::cerr << "argument error: number of roads should be in between 1 to 1000 inclusive" << std::endl;
-        std::terminate();
-    }
+        //  Errors of the input have been reported by the first pass
+        while (status == thomas::status::ok && (sketch.next_pass(), sketch.needs_pass())) {
+            thomas::error_buffer replayed(policy, 0, max_errors);
 
-    thomas::network network;
-
-    for (uint64_t i = 0; i < num_roads && std::getline(input_file, buffer_str); ++i) {
-        uint64_t shop_id, road_to;
+            status = load(path, format, header, max_reservation, sketch, replayed);
+        }
 
-        if (std::sscanf(buffer_str.data(), "%lu %lu", &shop_id, &road_to) != 2) {
-            std::cerr << "parsing error: unexpected char stray - \"" << buffer_str << "\"" << std::endl;
-            std::terminate();
+        if (status != thomas::status::ok) {
+            return static_cast<int32_t>(status);
         }
 
-        if (shop_id < 1 || shop_id > 1000) {
-            std::cerr << "warning: identifier for shop at line " << i + 2 << " is not in range 1 to 1000 inclusive: " << shop_id << std::endl;
-            continue;
+        const thomas::approximate_result result = sketch.result();
+
+        if (!result.guaranteed) {
+            std::cerr << "warning: maximum degree is within the error of the sketch, the result may be inexact" << std::endl;
         }
 
-        try {
-            thomas::shop *shop = network.shop_at(shop_id);
+        std::cout << result.disposed() << std::endl;
+
+        return 0;
+    }
 
-            try {
-                thomas::shop *dest = network.shop_at(road_to);
+    //  Exports and Arrow inputs work on the shops themselves, anything else is
+    //  reduced over compressed rows as narrow as the counts allow
+    if (format != thomas::format::arrow && edges_path.empty() && shops_path.empty()) {
+        thomas::edge_list edges;
 
-                dest->get_connected_shops().push_back(shop);
-                shop->get_connected_shops().push_back(dest);
-            } catch (std::out_of_range &oor2) {
-                DEBUG_STREAM << "line " << i + 2 << ": destination shop with identifier " << road_to << " is being instantiated" << std::endl;
+        status = load(path, format, header, max_reservation, edges, errors);
+        std::cerr << errors;
 
-                thomas::shop *new_dest = new thomas::shop(road_to);
+        if (status != thomas::status::ok) {
+            return static_cast<int32_t>(status);
+        }
 
-                new_dest->get_connected_shops().push_back(shop);
-                shop->get_connected_shops().push_back(new_dest);
+        std::cout << thomas::visit_narrowest(edges, [] (const auto &compressed) {
+            std::vector<uint64_t> impacts;
+            std::vector<size_t> disposed;
 
-                network.register_shop(new_dest);
+            if constexpr (thomas::debug_output) {
+                thomas::print(std::cout, compressed);
+                std::cout << "network size: " << thomas::count_connections(compressed) << std::endl;
             }
-        } catch (std::out_of_range &oor) {
-            DEBUG_STREAM << "line " << i + 2 << ": source shop with identifier " << shop_id << " is being instantiated" << std::endl;
 
-            thomas::shop *new_shop = new thomas::shop(shop_id);
+            return thomas::analyze(compressed, impacts, disposed).disposed();
+        }) << std::endl;
+
+        return 0;
+    }
+
+    thomas::network network;
 
-            try {
-                thomas::shop *dest = network.shop_at(road_to);
+    if (format == thomas::format::arrow) {
+        status = thomas::arrow::import_edges(path, network, errors);
+    } else {
+        status = load(path, format, header, max_reservation, network, errors);
+    }
 
-                dest->get_connected_shops().push_back(new_shop);
-                new_shop->get_connected_shops().push_back(dest);
-            } catch (std::out_of_range &oor2) {
-                DEBUG_STREAM << "line " << i + 2 << ": destination shop with identifier " << road_to << " is being instantiated" << std::endl;
+    std::cerr << errors;
 
-                thomas::shop *new_dest = new thomas::shop(road_to);
+    if (status != thomas::status::ok) {
+        return static_cast<int32_t>(status);
+    }
 
-                new_dest->get_connected_shops().push_back(new_shop);
-                new_shop->get_connected_shops().push_back(new_dest);
+    std::string error;
 
-                network.register_shop(new_dest);
-            }
+    if (!edges_path.empty() && !thomas::arrow::export_edges(network, edges_path, error)) {
+        std::cerr << "io error: " << error << std::endl;
+        return static_cast<int32_t>(thomas::status::io_error);
+    }
 
-            network.register_shop(new_shop);
-        }
+    if (!shops_path.empty() && !thomas::arrow::export_shops(network, shops_path, error)) {
+        std::cerr << "io error: " << error << std::endl;
+        return static_cast<int32_t>(thomas::status::io_error);
     }
 
-    DEBUG_STREAM << network;
-    DEBUG_STREAM << "network size: " << network.number_of_connections() << std::endl;
+    if constexpr (thomas::debug_output) {
+        std::cout << network;
+        std::cout << "network size: " << network.number_of_connections() << std::endl;
+    }
 
     std::cout << network.reduce() << std::endl;
 
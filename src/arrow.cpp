@@ -0,0 +1,285 @@
+#include "thomas/arrow.hpp"
+
+#include <cstdio>
+
+namespace thomas {
+    namespace arrow {
+        uint32_t build_schema(flatbuffer_builder &builder, const std::vector<column> &columns) {
+            std::vector<uint32_t> fields;
+
+            for (auto &each_column : columns) {
+                const uint32_t name = builder.string(each_column.name);
+
+                builder.start_table();
+
+                if (each_column.type == type::uint64) {
+                    builder.add_scalar<int32_t>(0, 64);
+                    builder.add_scalar<uint8_t>(1, 0);
+                }
+
+                const uint32_t column_type = builder.end_table();
+                const uint32_t children = builder.offset_vector({});
+
+                builder.start_table();
+                builder.add_offset(0, name);
+                builder.add_scalar<uint8_t>(1, 0);
+                builder.add_scalar<uint8_t>(2, each_column.type == type::uint64 ? type_int : type_bool);
+                builder.add_offset(3, column_type);
+                builder.add_offset(5, children);
+                fields.push_back(builder.end_table());
+            }
+
+            const uint32_t field_vector = builder.offset_vector(fields);
+
+            builder.start_table();
+            builder.add_scalar<int16_t>(0, 0);
+            builder.add_offset(1, field_vector);
+
+            return builder.end_table();
+        }
+
+        std::vector<uint8_t> build_message(flatbuffer_builder &builder, const uint8_t header_type, const uint32_t header, const int64_t body_length) {
+            builder.start_table();
+            builder.add_scalar<int16_t>(0, metadata_version);
+            builder.add_scalar<uint8_t>(1, header_type);
+            builder.add_offset(2, header);
+            builder.add_scalar<int64_t>(3, body_length);
+
+            return builder.finish(builder.end_table());
+        }
+
+        class _file_writer {
+        private:
+            std::FILE *file;
+            uint64_t position = 0;
+            bool failed = false;
+
+        public:
+            explicit _file_writer(const std::string &path) : file(std::fopen(path.c_str(), "wb")) {
+                failed = file == nullptr;
+            }
+
+            virtual ~_file_writer() {
+                if (file != nullptr) {
+                    std::fclose(file);
+                }
+            }
+
+            inline uint64_t get_position() const noexcept {
+                return position;
+            }
+
+            inline void write(const void *data, const size_t length) {
+                if (!failed && length != 0 && std::fwrite(data, 1, length, file) != length) {
+                    failed = true;
+                }
+
+                position += length;
+            }
+
+            inline void pad_to(const size_t alignment) {
+                static const uint8_t zeros[buffer_alignment] = {};
+
+                write(zeros, padded(position, alignment) - position);
+            }
+
+            /**
+             write_message()
+             Writes an encapsulated message, padding the metadata so that the body starts aligned.
+
+             @return The footer block of the message.
+             */
+            inline _block write_message(const std::vector<uint8_t> &metadata, const int64_t body_length) {
+                const uint64_t start = position;
+                const int32_t length = static_cast<int32_t>(padded(start + 8 + metadata.size(), buffer_alignment) - start - 8);
+                const uint32_t continuation = 0xFFFFFFFF;
+
+                write(&continuation, sizeof(continuation));
+                write(&length, sizeof(length));
+                write(metadata.data(), metadata.size());
+                pad_to(buffer_alignment);
+
+                return { static_cast<int64_t>(start), length + 8, 0, body_length };
+            }
+
+            inline bool close() {
+                if (file != nullptr && std::fclose(file) != 0) {
+                    failed = true;
+                }
+
+                file = nullptr;
+
+                return !failed;
+            }
+        };
+
+        bool write_table(const std::string &path, const std::vector<column> &columns, const uint64_t rows, std::string &error) {
+            _file_writer writer(path);
+
+            writer.write(magic, 6);
+            writer.pad_to(8);
+
+            flatbuffer_builder schema_builder;
+            const uint32_t schema = build_schema(schema_builder, columns);
+
+            writer.write_message(build_message(schema_builder, header_schema, schema, 0), 0);
+
+            //  Each column has an empty validity bitmap followed by its values
+            std::vector<_field_node> nodes;
+            std::vector<_buffer> buffers;
+            int64_t body_length = 0;
+
+            for (auto &each_column : columns) {
+                const int64_t length = static_cast<int64_t>(values_length(each_column.type, rows));
+
+                nodes.push_back({ static_cast<int64_t>(rows), 0 });
+                buffers.push_back({ body_length, 0 });
+                buffers.push_back({ body_length, length });
+                body_length += static_cast<int64_t>(padded(static_cast<size_t>(length), buffer_alignment));
+            }
+
+            flatbuffer_builder batch_builder;
+            const uint32_t node_vector = batch_builder.struct_vector(nodes.data(), nodes.size(), sizeof(_field_node));
+            const uint32_t buffer_vector = batch_builder.struct_vector(buffers.data(), buffers.size(), sizeof(_buffer));
+
+            batch_builder.start_table();
+            batch_builder.add_scalar<int64_t>(0, static_cast<int64_t>(rows));
+            batch_builder.add_offset(1, node_vector);
+            batch_builder.add_offset(2, buffer_vector);
+
+            const uint32_t batch = batch_builder.end_table();
+            const _block block = writer.write_message(build_message(batch_builder, header_record_batch, batch, body_length), body_length);
+
+            for (auto &each_column : columns) {
+                writer.write(each_column.values, values_length(each_column.type, rows));
+                writer.pad_to(buffer_alignment);
+            }
+
+            //  End-of-stream marker
+            const uint32_t end_of_stream[2] = { 0xFFFFFFFF, 0 };
+            writer.write(end_of_stream, sizeof(end_of_stream));
+
+            flatbuffer_builder footer_builder;
+            const uint32_t footer_schema = build_schema(footer_builder, columns);
+            const uint32_t dictionaries = footer_builder.struct_vector(nullptr, 0, sizeof(_block));
+            const uint32_t record_batches = footer_builder.struct_vector(&block, 1, sizeof(_block));
+
+            footer_builder.start_table();
+            footer_builder.add_scalar<int16_t>(0, metadata_version);
+            footer_builder.add_offset(1, footer_schema);
+            footer_builder.add_offset(2, dictionaries);
+            footer_builder.add_offset(3, record_batches);
+
+            const std::vector<uint8_t> footer = footer_builder.finish(footer_builder.end_table());
+            const int32_t footer_length = static_cast<int32_t>(footer.size());
+
+            writer.write(footer.data(), footer.size());
+            writer.write(&footer_length, sizeof(footer_length));
+            writer.write(magic, 6);
+
+            if (!writer.close()) {
+                error = "couldn't write \"" + path + "\"";
+                return false;
+            }
+
+            return true;
+        }
+
+        bool export_edges(network &network, const std::string &path, std::string &error) {
+            std::vector<uint64_t> sources, targets;
+
+            sources.reserve(network.number_of_connections() / 2);
+            targets.reserve(sources.capacity());
+
+            for (auto &shop : network.get_shops()) {
+                uint64_t loops = 0;
+
+                for (auto &remote_shop : shop->get_connected_shops()) {
+                    if (remote_shop == shop) {
+                        ++loops;
+                    } else if (shop->get_identifier() < remote_shop->get_identifier()) {
+                        sources.push_back(shop->get_identifier());
+                        targets.push_back(remote_shop->get_identifier());
+                    }
+                }
+
+                //  A road to itself is listed twice in the connections
+                for (uint64_t i = 0; i < loops / 2; ++i) {
+                    sources.push_back(shop->get_identifier());
+                    targets.push_back(shop->get_identifier());
+                }
+            }
+
+            return write_table(path, {
+                { "source", type::uint64, sources.data() },
+                { "target", type::uint64, targets.data() }
+            }, sources.size(), error);
+        }
+
+        bool export_shops(network &network, const std::string &path, std::string &error) {
+            const size_t count = network.number_of_shops();
+            std::vector<uint64_t> identifiers, degrees, impacts;
+            std::vector<size_t> tied;
+            std::vector<uint8_t> disposed((count + 7) / 8, 0);
+
+            const reduce_result result = thomas::analyze(network, impacts, tied);
+
+            identifiers.reserve(count);
+            degrees.reserve(count);
+
+            for (size_t i = 0; i < count; ++i) {
+                identifiers.push_back(network.identifier_at(i));
+                degrees.push_back(network.degree(i));
+
+                //  analyze() only gathers the impacts of the shops at the threshold
+                if (degrees.back() != result.threshold) {
+                    impacts[i] = network.external_impact(i, result.threshold);
+                }
+            }
+
+            //  A single shop at the maximum is not disposed
+            if (result.disposed() != 0) {
+                for (auto &i : result.shops) {
+                    disposed[i / 8] |= static_cast<uint8_t>(1u << (i % 8));
+                }
+            }
+
+            return write_table(path, {
+                { "identifier", type::uint64, identifiers.data() },
+                { "degree", type::uint64, degrees.data() },
+                { "impact", type::uint64, impacts.data() },
+                { "disposed", type::boolean, disposed.data() }
+            }, count, error);
+        }
+
+        status import_edges(const std::string &path, network &network, error_buffer &errors) {
+            table_reader reader;
+            std::string error;
+            const status result = reader.open(path, error);
+
+            if (result != status::ok) {
+                errors.report(0, result, error);
+                return result;
+            }
+
+            const size_t source = reader.column_index("source", type::uint64);
+            const size_t target = reader.column_index("target", type::uint64);
+
+            if (source == reader.get_columns().size() || target == reader.get_columns().size()) {
+                errors.report(0, status::parse_error, "expected uint64 columns \"source\" and \"target\"");
+                return status::parse_error;
+            }
+
+            for (auto &each_batch : reader.get_batches()) {
+                const uint64_t *sources = static_cast<const uint64_t *>(each_batch.values[source]);
+                const uint64_t *targets = static_cast<const uint64_t *>(each_batch.values[target]);
+
+                for (uint64_t i = 0; i < each_batch.rows; ++i) {
+                    network.connect(sources[i], targets[i]);
+                }
+            }
+
+            return status::ok;
+        }
+    }
+}
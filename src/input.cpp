@@ -0,0 +1,208 @@
+#include "thomas/input.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#ifdef THOMAS_ENABLE_ZLIB
+#include <zlib.h>
+#endif
+
+#ifdef THOMAS_ENABLE_ZSTD
+#include <zstd.h>
+#endif
+
+namespace thomas {
+    input::input(const char *path) {
+        file = std::fopen(path, "rb");
+
+        if (file == nullptr) {
+            return;
+        }
+
+        unsigned char magic[4] = { 0, 0, 0, 0 };
+        const size_t length = std::fread(magic, 1, sizeof(magic), file);
+
+        prefix.assign(magic, magic + length);
+
+        if (length >= 2 && magic[0] == 0x1f && magic[1] == 0x8b) {
+            kind = compression::gzip;
+        } else if (length == 4 && magic[0] == 0x28 && magic[1] == 0xb5 && magic[2] == 0x2f && magic[3] == 0xfd) {
+            kind = compression::zstd;
+        }
+
+        switch (kind) {
+            case compression::none:
+                //  Plain files are read on the calling thread
+                current = prefix;
+                return;
+#ifndef THOMAS_ENABLE_ZLIB
+            case compression::gzip:
+                error = "gzip input requires building with THOMAS_ENABLE_ZLIB";
+                finished = true;
+                return;
+#endif
+#ifndef THOMAS_ENABLE_ZSTD
+            case compression::zstd:
+                error = "zstd input requires building with THOMAS_ENABLE_ZSTD";
+                finished = true;
+                return;
+#endif
+            default:
+                break;
+        }
+
+        worker = std::thread(&input::decode, this);
+    }
+
+#ifdef THOMAS_ENABLE_ZLIB
+    void input::inflate_gzip() {
+        z_stream stream;
+        std::memset(&stream, 0, sizeof(stream));
+
+        //  15 window bits with the gzip wrapper
+        if (inflateInit2(&stream, 15 + 16) != Z_OK) {
+            fail("gzip decoder couldn't be initialized");
+            return;
+        }
+
+        std::vector<char> in(chunk_size);
+        std::vector<char> out(chunk_size);
+        size_t out_size = 0;
+        bool ended = false;
+
+        std::copy(prefix.begin(), prefix.end(), in.begin());
+        stream.next_in = reinterpret_cast<Bytef *>(in.data());
+        stream.avail_in = static_cast<uInt>(prefix.size());
+
+        for (;;) {
+            if (stream.avail_in == 0) {
+                const size_t length = std::fread(in.data(), 1, in.size(), file);
+
+                if (length == 0) {
+                    break;
+                }
+
+                stream.next_in = reinterpret_cast<Bytef *>(in.data());
+                stream.avail_in = static_cast<uInt>(length);
+            }
+
+            stream.next_out = reinterpret_cast<Bytef *>(out.data() + out_size);
+            stream.avail_out = static_cast<uInt>(out.size() - out_size);
+
+            const int status = inflate(&stream, Z_NO_FLUSH);
+
+            out_size = out.size() - stream.avail_out;
+            ended = status == Z_STREAM_END;
+
+            if (ended) {
+                //  Concatenated members are decoded as a single stream
+                inflateReset(&stream);
+            } else if (status != Z_OK) {
+                fail("gzip stream is corrupt");
+                break;
+            }
+
+            if (out_size == out.size()) {
+                if (!push(std::move(out))) {
+                    break;
+                }
+
+                out.assign(chunk_size, 0);
+                out_size = 0;
+            }
+        }
+
+        if (!ended && stream.avail_in == 0 && std::feof(file)) {
+            fail("gzip stream is truncated");
+        }
+
+        inflateEnd(&stream);
+
+        if (out_size != 0) {
+            out.resize(out_size);
+            push(std::move(out));
+        }
+    }
+#endif
+
+#ifdef THOMAS_ENABLE_ZSTD
+    void input::decompress_zstd() {
+        ZSTD_DStream *stream = ZSTD_createDStream();
+
+        if (stream == nullptr || ZSTD_isError(ZSTD_initDStream(stream))) {
+            ZSTD_freeDStream(stream);
+            fail("zstd decoder couldn't be initialized");
+            return;
+        }
+
+        std::vector<char> in(ZSTD_DStreamInSize());
+        std::vector<char> out(chunk_size);
+        size_t out_size = 0;
+        size_t hint = 1;
+
+        std::copy(prefix.begin(), prefix.end(), in.begin());
+        ZSTD_inBuffer source = { in.data(), prefix.size(), 0 };
+
+        for (;;) {
+            if (source.pos == source.size) {
+                const size_t length = std::fread(in.data(), 1, in.size(), file);
+
+                if (length == 0) {
+                    break;
+                }
+
+                source = { in.data(), length, 0 };
+            }
+
+            ZSTD_outBuffer sink = { out.data(), out.size(), out_size };
+            hint = ZSTD_decompressStream(stream, &sink, &source);
+            out_size = sink.pos;
+
+            if (ZSTD_isError(hint)) {
+                fail(std::string("zstd stream is corrupt: ") + ZSTD_getErrorName(hint));
+                break;
+            }
+
+            if (out_size == out.size()) {
+                if (!push(std::move(out))) {
+                    break;
+                }
+
+                out.assign(chunk_size, 0);
+                out_size = 0;
+            }
+        }
+
+        //  A non-zero hint at the end of input means the last frame is incomplete
+        if (hint != 0 && !ZSTD_isError(hint) && std::feof(file)) {
+            fail("zstd stream is truncated");
+        }
+
+        ZSTD_freeDStream(stream);
+
+        if (out_size != 0) {
+            out.resize(out_size);
+            push(std::move(out));
+        }
+    }
+#endif
+
+    void input::decode() {
+        switch (kind) {
+#ifdef THOMAS_ENABLE_ZLIB
+            case compression::gzip:
+                inflate_gzip();
+                break;
+#endif
+#ifdef THOMAS_ENABLE_ZSTD
+            case compression::zstd:
+                decompress_zstd();
+                break;
+#endif
+            default:
+                break;
+        }
+
+        finish();
+    }
+}
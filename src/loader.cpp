@@ -0,0 +1,412 @@
+#include "thomas/loader.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <new>
+#include <stdexcept>
+
+#include "thomas/parse.hpp"
+
+namespace thomas {
+    /**
+     reserve_declared()
+     Pre-sizes the network for the counts of a header. Declared counts may
+     be anything, so they are capped to the given bound, and identifiers
+     above it are hashed rather than indexed directly. Storage which can't
+     be allocated is reported as a range error.
+
+     @return The status of the reservation.
+     */
+    template <typename Network>
+    status reserve_declared(Network &network, error_buffer &errors, const uint64_t line_number, const uint64_t max_reservation,
+                            uint64_t num_shops, uint64_t num_roads, uint64_t max_identifier) {
+        num_shops = std::min(num_shops, max_reservation);
+        num_roads = std::min(num_roads, max_reservation);
+        max_identifier = max_identifier <= max_reservation ? max_identifier : 0;
+
+        try {
+            network.reserve(num_shops, num_roads, max_identifier);
+        } catch (const std::bad_alloc &) {
+            errors.report(line_number, status::range_error, "declared counts are too large to reserve storage for");
+            return status::range_error;
+        } catch (const std::length_error &) {
+            errors.report(line_number, status::range_error, "declared counts are too large to reserve storage for");
+            return status::range_error;
+        }
+
+        return status::ok;
+    }
+
+    template <typename Network>
+    status import_native(input &in, Network &network, error_buffer &errors, const header_mode header, const uint64_t max_reservation) {
+        std::string line;
+        uint64_t line_number = 0;
+        uint64_t num_shops = 0, num_roads = 0;
+
+        //  Fetch the number of shops and roads
+        if (header != header_mode::none) {
+            const bool has_line = in.getline(line);
+            ++line_number;
+
+            if (header != header_mode::ignore && (!has_line || !parse_pair(line, num_shops, num_roads))) {
+                errors.report(1, status::parse_error, "couldn't parse header");
+                return status::parse_error;
+            }
+        }
+
+        if (header == header_mode::trust) {
+            if (num_shops < 2 || num_shops > 1000) {
+                errors.report(1, status::range_error, "number of shops should be in between 2 to 1000 inclusive");
+                return status::range_error;
+            }
+
+            if (num_roads < 1 || num_roads > 1000) {
+                errors.report(1, status::range_error, "number of roads should be in between 1 to 1000 inclusive");
+                return status::range_error;
+            }
+        }
+
+        if (header == header_mode::trust || header == header_mode::verify) {
+            //  Shops are identified by 1 to 1000, trusted counts are bounded above
+            const status reserved = reserve_declared(network, errors, 1, header == header_mode::trust ? UINT64_MAX : max_reservation,
+                                                     num_shops, num_roads, 1000);
+
+            if (reserved != status::ok) {
+                return reserved;
+            }
+        }
+
+        const uint64_t limit = header == header_mode::trust ? num_roads : UINT64_MAX;
+        uint64_t roads = 0;
+
+        while (roads < limit && in.getline(line)) {
+            ++line_number;
+
+            //  Blank lines are only tolerated when reading up to the end of file
+            if (header != header_mode::trust && is_empty_line(line)) {
+                continue;
+            }
+
+            ++roads;
+
+            uint64_t shop_id, road_to;
+
+            if (!parse_pair(line, shop_id, road_to)) {
+                if (!errors.report(line_number, status::parse_error, "unexpected char stray - \"" + line + "\"")) {
+                    return errors.stopped();
+                }
+
+                continue;
+            }
+
+            if (shop_id < 1 || shop_id > 1000) {
+                errors.warn(line_number, status::range_error, "identifier for shop is not in range 1 to 1000 inclusive: " + std::to_string(shop_id));
+                continue;
+            }
+
+            network.connect(shop_id, road_to);
+        }
+
+        //  A mismatching header fails the import under either policy, as it is
+        //  no line to skip; the roads have been read regardless
+        status result = status::ok;
+
+        if (header == header_mode::verify) {
+            if (roads != num_roads) {
+                if (!errors.report(0, status::range_error, "header declares " + std::to_string(num_roads) + " roads, found " + std::to_string(roads))) {
+                    return errors.stopped();
+                }
+
+                result = status::range_error;
+            }
+
+            if (network.number_of_shops() != num_shops) {
+                if (!errors.report(0, status::range_error, "header declares " + std::to_string(num_shops) + " shops, found " + std::to_string(network.number_of_shops()))) {
+                    return errors.stopped();
+                }
+
+                result = status::range_error;
+            }
+        }
+
+        return result;
+    }
+
+    template <typename Network>
+    status import_metis(input &in, Network &network, error_buffer &errors, const uint64_t max_reservation) {
+        std::string line;
+        uint64_t line_number = 0;
+
+        //  Skip the comments preceding the header
+        do {
+            if (!in.getline(line)) {
+                errors.report(line_number, status::parse_error, "missing METIS header");
+                return status::parse_error;
+            }
+
+            ++line_number;
+        } while (line.empty() || line[0] == '%');
+
+        const char *cursor = line.data();
+        const char *end = cursor + line.size();
+        uint64_t num_vertices, num_edges, fmt = 0, ncon = 0;
+
+        if (!parse_unsigned(cursor, end, num_vertices) || !parse_unsigned(cursor, end, num_edges)) {
+            errors.report(line_number, status::parse_error, "couldn't parse METIS header");
+            return status::parse_error;
+        }
+
+        if (parse_unsigned(cursor, end, fmt) && !parse_unsigned(cursor, end, ncon)) {
+            ncon = 0;
+        }
+
+        //  Vertices are numbered from 1 to the vertex count
+        const status reserved = reserve_declared(network, errors, line_number, max_reservation, num_vertices, num_edges, num_vertices);
+
+        if (reserved != status::ok) {
+            return reserved;
+        }
+
+        //  The format digits are read as decimal, e.g. "011" is parsed as 11
+        const bool has_sizes = (fmt / 100) % 10 != 0;
+        const bool has_vertex_weights = (fmt / 10) % 10 != 0;
+        const bool has_edge_weights = fmt % 10 != 0;
+        const uint64_t num_prefix = (has_sizes ? 1 : 0) + (has_vertex_weights ? (ncon == 0 ? 1 : ncon) : 0);
+
+        uint64_t vertex = 0;
+
+        while (vertex < num_vertices && in.getline(line)) {
+            ++line_number;
+
+            if (!line.empty() && line[0] == '%') {
+                continue;
+            }
+
+            ++vertex;
+            network.find_or_register(vertex);
+
+            cursor = line.data();
+            end = cursor + line.size();
+
+            uint64_t value;
+            bool valid = true;
+
+            for (uint64_t i = 0; i < num_prefix && valid; ++i) {
+                valid = parse_unsigned(cursor, end, value);
+            }
+
+            if (!valid) {
+                if (!errors.report(line_number, status::parse_error, "missing vertex weight")) {
+                    return errors.stopped();
+                }
+
+                continue;
+            }
+
+            for (;;) {
+                skip_blanks(cursor, end);
+
+                if (cursor == end) {
+                    break;
+                }
+
+                uint64_t neighbor;
+
+                if (!parse_unsigned(cursor, end, neighbor) || (has_edge_weights && !parse_unsigned(cursor, end, value))) {
+                    if (!errors.report(line_number, status::parse_error, "unexpected char stray - \"" + line + "\"")) {
+                        return errors.stopped();
+                    }
+
+                    break;
+                }
+
+                if (neighbor < 1 || neighbor > num_vertices) {
+                    if (!errors.report(line_number, status::range_error, "vertex out of range: " + std::to_string(neighbor))) {
+                        return errors.stopped();
+                    }
+
+                    continue;
+                }
+
+                if (vertex < neighbor) {
+                    network.connect(vertex, neighbor);
+                }
+            }
+        }
+
+        if (vertex != num_vertices) {
+            errors.report(0, status::parse_error, "expected " + std::to_string(num_vertices) + " adjacency lines, got " + std::to_string(vertex));
+            return status::parse_error;
+        }
+
+        return status::ok;
+    }
+
+    template <typename Network>
+    status import_matrix_market(input &in, Network &network, error_buffer &errors, const uint64_t max_reservation) {
+        std::string line;
+        uint64_t line_number = 1;
+
+        if (!in.getline(line) || line.compare(0, 14, "%%MatrixMarket") != 0) {
+            errors.report(1, status::parse_error, "missing Matrix Market banner");
+            return status::parse_error;
+        }
+
+        std::string banner = line;
+        std::transform(banner.begin(), banner.end(), banner.begin(), [] (char c) {
+            return static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+        });
+
+        if (banner.find(" matrix ") == std::string::npos || banner.find(" coordinate") == std::string::npos) {
+            errors.report(1, status::parse_error, "only coordinate matrices can be read as a network");
+            return status::parse_error;
+        }
+
+        //  Skip the comments preceding the size line
+        do {
+            if (!in.getline(line)) {
+                errors.report(line_number, status::parse_error, "missing Matrix Market size line");
+                return status::parse_error;
+            }
+
+            ++line_number;
+        } while (is_empty_line(line) || line[0] == '%');
+
+        const char *cursor = line.data();
+        const char *end = cursor + line.size();
+        uint64_t rows, columns, entries;
+
+        if (!parse_unsigned(cursor, end, rows) || !parse_unsigned(cursor, end, columns) || !parse_unsigned(cursor, end, entries)) {
+            errors.report(line_number, status::parse_error, "couldn't parse Matrix Market size line");
+            return status::parse_error;
+        }
+
+        const status reserved = reserve_declared(network, errors, line_number, max_reservation, std::max(rows, columns), entries, std::max(rows, columns));
+
+        if (reserved != status::ok) {
+            return reserved;
+        }
+
+        uint64_t entry = 0;
+
+        while (entry < entries && in.getline(line)) {
+            ++line_number;
+
+            if (is_empty_line(line) || line[0] == '%') {
+                continue;
+            }
+
+            //  Skipped entries still count towards the declared number
+            ++entry;
+
+            cursor = line.data();
+            end = cursor + line.size();
+
+            uint64_t row, column;
+
+            //  Values following the coordinates are not used
+            if (!parse_unsigned(cursor, end, row) || !parse_unsigned(cursor, end, column)) {
+                if (!errors.report(line_number, status::parse_error, "unexpected char stray - \"" + line + "\"")) {
+                    return errors.stopped();
+                }
+
+                continue;
+            }
+
+            if (row < 1 || row > rows || column < 1 || column > columns) {
+                if (!errors.report(line_number, status::range_error, "entry out of range - \"" + line + "\"")) {
+                    return errors.stopped();
+                }
+
+                continue;
+            }
+
+            network.connect(row, column);
+        }
+
+        if (entry != entries) {
+            errors.report(0, status::parse_error, "expected " + std::to_string(entries) + " entries, got " + std::to_string(entry));
+            return status::parse_error;
+        }
+
+        return status::ok;
+    }
+
+    template <typename Network>
+    status import_snap(input &in, Network &network, error_buffer &errors) {
+        std::string line;
+        uint64_t line_number = 0;
+
+        while (in.getline(line)) {
+            ++line_number;
+
+            if (is_empty_line(line) || line[0] == '#') {
+                continue;
+            }
+
+            uint64_t from, to;
+
+            if (!parse_pair(line, from, to)) {
+                if (!errors.report(line_number, status::parse_error, "unexpected char stray - \"" + line + "\"")) {
+                    return errors.stopped();
+                }
+
+                continue;
+            }
+
+            network.connect(from, to);
+        }
+
+        return status::ok;
+    }
+
+    template <typename Network>
+    status import(const format format, input &in, Network &network, error_buffer &errors, const header_mode header, const uint64_t max_reservation) {
+        status result = status::ok;
+
+        switch (format) {
+            case format::native:
+                result = import_native(in, network, errors, header, max_reservation);
+                break;
+            case format::metis:
+                result = import_metis(in, network, errors, max_reservation);
+                break;
+            case format::matrix_market:
+                result = import_matrix_market(in, network, errors, max_reservation);
+                break;
+            case format::snap:
+                result = import_snap(in, network, errors);
+                break;
+            case format::arrow:
+                //  Arrow files are mapped instead, see arrow::import_edges()
+                errors.report(0, status::argument_error, "arrow files can't be read as a stream");
+                return status::argument_error;
+        }
+
+        //  A failing decoder looks like an early end of file to the importers
+        if (in.has_failed()) {
+            errors.report(0, status::io_error, in.get_error());
+            return status::io_error;
+        }
+
+        return result;
+    }
+
+    template status import_native(input &, network &, error_buffer &, const header_mode, const uint64_t);
+    template status import_metis(input &, network &, error_buffer &, const uint64_t);
+    template status import_matrix_market(input &, network &, error_buffer &, const uint64_t);
+    template status import_snap(input &, network &, error_buffer &);
+    template status import(const format, input &, network &, error_buffer &, const header_mode, const uint64_t);
+
+    template status import_native(input &, edge_list &, error_buffer &, const header_mode, const uint64_t);
+    template status import_metis(input &, edge_list &, error_buffer &, const uint64_t);
+    template status import_matrix_market(input &, edge_list &, error_buffer &, const uint64_t);
+    template status import_snap(input &, edge_list &, error_buffer &);
+    template status import(const format, input &, edge_list &, error_buffer &, const header_mode, const uint64_t);
+
+    template status import_native(input &, heavy_hitters &, error_buffer &, const header_mode, const uint64_t);
+    template status import_metis(input &, heavy_hitters &, error_buffer &, const uint64_t);
+    template status import_matrix_market(input &, heavy_hitters &, error_buffer &, const uint64_t);
+    template status import_snap(input &, heavy_hitters &, error_buffer &);
+    template status import(const format, input &, heavy_hitters &, error_buffer &, const header_mode, const uint64_t);
+}
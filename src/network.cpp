@@ -0,0 +1,7 @@
+#include "thomas/network.hpp"
+
+namespace thomas {
+    std::ostream &operator<< (std::ostream &os, network &network) {
+        return print(os, network);
+    }
+}
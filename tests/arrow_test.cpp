@@ -0,0 +1,149 @@
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "thomas/thomas.hpp"
+#include "test_support.hpp"
+
+//  Round trips random networks through the Arrow edge and shop tables, and
+//  checks that files with a corrupted record batch are rejected.
+
+void check_round_trip(const std::vector<test::road> &roads, const std::filesystem::path &directory) {
+    const std::string edges_path = (directory / "thomas_arrow_test_edges.arrow").string();
+    const std::string shops_path = (directory / "thomas_arrow_test_shops.arrow").string();
+    const uint64_t reference = test::reference_reduce(roads);
+    thomas::network network, imported;
+    std::string error;
+
+    for (auto &each : roads) {
+        network.connect(each.first, each.second);
+    }
+
+    CHECK(thomas::arrow::export_edges(network, edges_path, error));
+    CHECK(thomas::arrow::export_shops(network, shops_path, error));
+
+    thomas::error_buffer errors;
+    CHECK(thomas::arrow::import_edges(edges_path, imported, errors) == thomas::status::ok);
+    CHECK(imported.number_of_connections() == network.number_of_connections());
+    CHECK(imported.reduce() == reference);
+
+    thomas::arrow::table_reader reader;
+
+    if (CHECK(reader.open(shops_path, error) == thomas::status::ok)) {
+        const size_t degree = reader.column_index("degree", thomas::arrow::type::uint64);
+        const size_t impact = reader.column_index("impact", thomas::arrow::type::uint64);
+        const size_t disposed = reader.column_index("disposed", thomas::arrow::type::boolean);
+        const thomas::reduce_result result = network.analyze();
+        uint64_t flagged = 0;
+        size_t i = 0;
+
+        for (auto &each_batch : reader.get_batches()) {
+            const uint64_t *degrees = static_cast<const uint64_t *>(each_batch.values[degree]);
+            const uint64_t *impacts = static_cast<const uint64_t *>(each_batch.values[impact]);
+            const uint8_t *flags = static_cast<const uint8_t *>(each_batch.values[disposed]);
+
+            for (uint64_t row = 0; row < each_batch.rows; ++row, ++i) {
+                CHECK(degrees[row] == network.degree(i));
+                CHECK(impacts[row] == network.external_impact(i, result.threshold));
+                flagged += (flags[row / 8] >> (row % 8)) & 1;
+            }
+        }
+
+        CHECK(i == network.number_of_shops());
+        CHECK(flagged == reference);
+    }
+
+    std::filesystem::remove(edges_path);
+    std::filesystem::remove(shops_path);
+}
+
+/**
+ patch()
+ Replaces every 64 bit little endian occurrence of a value in the file.
+
+ @return The number of occurrences replaced.
+ */
+size_t patch(std::vector<char> &bytes, const int64_t from, const int64_t to) {
+    size_t replaced = 0;
+
+    for (size_t i = 0; i + sizeof(int64_t) <= bytes.size(); ++i) {
+        if (std::memcmp(bytes.data() + i, &from, sizeof(int64_t)) == 0) {
+            std::memcpy(bytes.data() + i, &to, sizeof(int64_t));
+            ++replaced;
+        }
+    }
+
+    return replaced;
+}
+
+void check_malformed(const std::filesystem::path &directory) {
+    const std::string path = (directory / "thomas_arrow_test_malformed.arrow").string();
+    std::mt19937_64 engine(530);
+    thomas::network network;
+    std::string error;
+
+    //  999 roads of small identifiers: rows of 999, columns of 7992 bytes padded
+    //  to 8000, a body of 16000 bytes, none of which is an identifier
+    for (auto &each : test::random_roads(engine, 100, 999, 0, 0)) {
+        network.connect(each.first, each.second);
+    }
+
+    if (!CHECK(thomas::arrow::export_edges(network, path, error))) {
+        return;
+    }
+
+    std::ifstream in(path, std::ios::binary);
+    const std::vector<char> original((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+    in.close();
+
+    struct corruption {
+        int64_t from;
+        int64_t to;
+    };
+
+    const std::vector<corruption> corruptions = {
+        //  Row counts whose values would wrap around, or negative
+        { 999, int64_t(1) << 61 },
+        { 999, -1 },
+        //  Buffers shorter than their rows, a body beyond the end of the file
+        { 7992, 8 },
+        { 16000, int64_t(1) << 40 },
+        //  Buffer offsets negative, or overflowing with their length
+        { 8000, -64 },
+        { 8000, INT64_MAX - 63 }
+    };
+
+    for (auto &each : corruptions) {
+        std::vector<char> bytes = original;
+        thomas::network imported;
+        thomas::error_buffer errors;
+
+        CHECK(patch(bytes, each.from, each.to) != 0);
+        std::ofstream(path, std::ios::binary).write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+
+        CHECK(thomas::arrow::import_edges(path, imported, errors) == thomas::status::parse_error);
+        CHECK(imported.number_of_shops() == 0);
+    }
+
+    std::filesystem::remove(path);
+}
+
+int main() {
+    const std::filesystem::path directory = std::filesystem::temp_directory_path();
+    std::mt19937_64 engine(53);
+
+    for (int round = 0; round < 100; ++round) {
+        check_round_trip(test::random_roads(engine, 2 + engine() % 40, 1 + engine() % 120), directory);
+    }
+
+    check_round_trip({ { 1, 2 }, { 2, 3 }, { 3, 1 } }, directory);
+    check_malformed(directory);
+
+    return test::report();
+}
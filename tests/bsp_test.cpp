@@ -0,0 +1,169 @@
+#include <cstdint>
+#include <queue>
+#include <random>
+#include <vector>
+
+#include "thomas/thomas.hpp"
+#include "test_support.hpp"
+
+//  Runs vertex programs over random networks and their compressed rows: BFS
+//  levels against a serial BFS, components against a union-find, and the
+//  reduction, with a summing combiner, against network::reduce().
+
+struct sum_combiner {
+    inline uint64_t operator()(const uint64_t a, const uint64_t b) const noexcept {
+        return a + b;
+    }
+};
+
+std::vector<uint64_t> serial_levels(const thomas::network &network, const size_t source) {
+    std::vector<uint64_t> levels(network.number_of_shops(), UINT64_MAX);
+    std::queue<size_t> pending;
+
+    levels[source] = 0;
+    pending.push(source);
+
+    while (!pending.empty()) {
+        const size_t shop = pending.front();
+
+        pending.pop();
+
+        for (auto each : network.neighbors(shop)) {
+            if (levels[each] == UINT64_MAX) {
+                levels[each] = levels[shop] + 1;
+                pending.push(each);
+            }
+        }
+    }
+
+    return levels;
+}
+
+/**
+ bsp_reduce()
+ The reduction as a vertex program: every shop below the threshold sends its
+ degree along each of its connections, and the sum a tied shop receives is
+ its impact.
+ */
+template <typename Graph>
+uint64_t bsp_reduce(const Graph &graph, const unsigned threads) {
+    thomas::bsp_engine<Graph, uint64_t, sum_combiner> engine(graph, sum_combiner(), threads);
+    std::vector<uint64_t> impacts;
+    uint64_t threshold = 0;
+
+    for (size_t i = 0; i < graph.number_of_shops(); ++i) {
+        threshold = std::max<uint64_t>(threshold, graph.degree(i));
+    }
+
+    CHECK(engine.run(impacts, [threshold] (auto &context, uint64_t &impact, const uint64_t *message) {
+        const uint64_t degree = context.graph().degree(context.vertex());
+
+        if (context.superstep() == 0) {
+            impact = 0;
+
+            if (degree < threshold) {
+                context.send_to_neighbors(degree);
+            }
+        } else if (message != nullptr && degree == threshold) {
+            impact = *message;
+        }
+
+        context.vote_to_halt();
+    }) == thomas::status::ok);
+
+    CHECK(engine.get_supersteps() <= 2);
+
+    uint64_t required_impact = 0, count = 0;
+
+    for (size_t i = 0; i < graph.number_of_shops(); ++i) {
+        required_impact = graph.degree(i) == threshold ? std::max(required_impact, impacts[i]) : required_impact;
+    }
+
+    for (size_t i = 0; i < graph.number_of_shops(); ++i) {
+        count += graph.degree(i) == threshold && impacts[i] == required_impact ? 1 : 0;
+    }
+
+    return count < 2 ? 0 : count;
+}
+
+template <typename Graph>
+void check_programs(const Graph &graph, const thomas::network &network, const std::vector<uint32_t> &components, const uint64_t reference, const unsigned threads) {
+    std::vector<uint32_t> labels;
+    std::vector<uint64_t> levels;
+    size_t count = 0, expected = 0;
+
+    for (size_t i = 0; i < components.size(); ++i) {
+        expected += components[i] == i ? 1 : 0;
+    }
+
+    CHECK(thomas::connected_components(graph, labels, count, threads) == thomas::status::ok);
+    CHECK(labels == components);
+    CHECK(count == expected);
+
+    for (size_t source : { size_t(0), network.number_of_shops() / 2, network.number_of_shops() - 1 }) {
+        CHECK(thomas::bfs_levels(graph, source, levels, threads) == thomas::status::ok);
+        CHECK(levels == serial_levels(network, source));
+    }
+
+    CHECK(bsp_reduce(graph, threads) == reference);
+}
+
+void check_network(const std::vector<test::road> &roads, const unsigned threads) {
+    thomas::network network;
+    thomas::edge_list edges;
+    std::vector<test::road> indexed;
+
+    for (auto &each : roads) {
+        network.connect(each.first, each.second);
+        edges.connect(each.first, each.second);
+    }
+
+    for (size_t i = 0; i < network.number_of_shops(); ++i) {
+        for (auto each : network.neighbors(i)) {
+            indexed.push_back({ i, each });
+        }
+    }
+
+    const std::vector<uint32_t> components = test::reference_components(network.number_of_shops(), indexed);
+    const uint64_t reference = test::reference_reduce(roads);
+    thomas::csr_network<> compressed;
+
+    CHECK(compressed.assign(edges));
+    CHECK(network.reduce() == reference);
+
+    check_programs(network, network, components, reference, threads);
+    check_programs(compressed, network, components, reference, threads);
+}
+
+int main() {
+    std::mt19937_64 engine(75);
+
+    for (int round = 0; round < 200; ++round) {
+        //  Sparse enough for several components
+        const uint64_t num_shops = 2 + engine() % 150;
+
+        check_network(test::random_roads(engine, num_shops, 1 + engine() % num_shops), 1);
+        check_network(test::random_roads(engine, num_shops, 1 + engine() % 300), 1);
+    }
+
+    //  Large enough for messages across the ranges of the threads
+    check_network(test::random_roads(engine, 100000, 90000, 1, 5), 4);
+
+    //  The limit stops a run before it converges
+    thomas::network path;
+
+    for (uint64_t shop = 1; shop < 10; ++shop) {
+        path.connect(shop, shop + 1);
+    }
+
+    thomas::bsp_engine<thomas::network, uint32_t> engine_limited(path, thomas::min_combiner(), 1);
+    std::vector<uint32_t> values;
+
+    CHECK(engine_limited.run(values, [] (auto &context, uint32_t &value, const uint32_t *) {
+        value = static_cast<uint32_t>(context.superstep());
+    }, 3) == thomas::status::ok);
+    CHECK(engine_limited.get_supersteps() == 3);
+    CHECK(values[0] == 2);
+
+    return test::report();
+}
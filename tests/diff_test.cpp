@@ -0,0 +1,133 @@
+#include <cstdint>
+#include <map>
+#include <random>
+#include <vector>
+
+#include "thomas/thomas.hpp"
+#include "test_support.hpp"
+
+//  Diffs random snapshots of a network, and checks that the diff turns the
+//  first snapshot into the second, with the degree changes and reductions of
+//  both, for a network and for compressed rows on either side.
+
+std::map<uint64_t, int64_t> degrees_of(const std::vector<test::road> &roads) {
+    std::map<uint64_t, int64_t> degrees;
+
+    for (auto &each : roads) {
+        ++degrees[each.first];
+        ++degrees[each.second];
+    }
+
+    return degrees;
+}
+
+template <typename Before, typename After>
+void check_diff(const Before &before_graph, const After &after_graph, const std::vector<test::road> &before, const std::vector<test::road> &after, const unsigned threads) {
+    thomas::network_diff diff;
+
+    if (!CHECK(thomas::diff_networks(before_graph, after_graph, diff, threads) == thomas::status::ok)) {
+        return;
+    }
+
+    CHECK(diff.before.disposed == test::reference_reduce(before));
+    CHECK(diff.after.disposed == test::reference_reduce(after));
+    CHECK(diff.added.size() + before.size() == diff.removed.size() + after.size());
+
+    //  Degree changes of every shop of either snapshot
+    std::map<uint64_t, int64_t> expected = degrees_of(after);
+    std::map<uint64_t, int64_t> deltas;
+
+    for (auto &each : degrees_of(before)) {
+        expected[each.first] -= each.second;
+    }
+
+    for (auto &each : diff.degrees) {
+        CHECK(each.delta != 0);
+        deltas[each.identifier] = each.delta;
+    }
+
+    std::erase_if(expected, [] (const auto &each) {
+        return each.second == 0;
+    });
+
+    CHECK(deltas == expected);
+
+    //  Applying the diff gives the second snapshot
+    thomas::network network;
+
+    for (auto &each : before) {
+        network.connect(each.first, each.second);
+    }
+
+    CHECK(diff.apply(network));
+    CHECK(network.number_of_connections() == 2 * after.size());
+    CHECK(network.reduce_connections() == test::reference_reduce(after));
+
+    const std::map<uint64_t, int64_t> after_degrees = degrees_of(after);
+
+    for (size_t i = 0; i < network.number_of_shops(); ++i) {
+        const auto position = after_degrees.find(network.identifier_at(i));
+
+        CHECK(static_cast<int64_t>(network.degree(i)) == (position == after_degrees.end() ? 0 : position->second));
+    }
+}
+
+void check_snapshots(std::mt19937_64 &engine, const uint64_t num_shops, const size_t num_roads, const unsigned threads) {
+    const std::vector<test::road> before = test::random_roads(engine, num_shops, num_roads);
+    std::vector<test::road> after;
+
+    //  Some roads are dropped, and new ones come with shops of their own
+    for (auto &each : before) {
+        if (engine() % 4 != 0) {
+            after.push_back(each);
+        }
+    }
+
+    for (auto &each : test::random_roads(engine, num_shops + num_shops / 4, num_roads / 4 + 1)) {
+        after.push_back(each);
+    }
+
+    thomas::network before_network, after_network;
+    thomas::edge_list after_edges;
+
+    for (auto &each : before) {
+        before_network.connect(each.first, each.second);
+    }
+
+    for (auto &each : after) {
+        after_network.connect(each.first, each.second);
+        after_edges.connect(each.first, each.second);
+    }
+
+    thomas::csr_network<> after_compressed;
+
+    CHECK(after_compressed.assign(after_edges));
+
+    check_diff(before_network, after_network, before, after, threads);
+    check_diff(before_network, after_compressed, before, after, threads);
+    check_diff(after_network, before_network, after, before, threads);
+}
+
+int main() {
+    std::mt19937_64 engine(73);
+
+    for (int round = 0; round < 200; ++round) {
+        check_snapshots(engine, 2 + engine() % 40, 1 + engine() % 150, 1);
+    }
+
+    //  Large enough to merge in several ranges
+    check_snapshots(engine, 20000, 100000, 4);
+
+    //  Identical snapshots differ in nothing
+    thomas::network network;
+    thomas::network_diff diff;
+
+    network.connect(1, 2);
+    network.connect(2, 2);
+    network.connect(1, 2);
+
+    CHECK(thomas::diff_networks(network, network, diff) == thomas::status::ok);
+    CHECK(diff.added.empty() && diff.removed.empty() && diff.degrees.empty());
+
+    return test::report();
+}
@@ -0,0 +1,97 @@
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "thomas/thomas.hpp"
+#include "test_support.hpp"
+
+//  Runs the edge centric algorithms over random networks, split into
+//  partitions of the default size and of a few shops, and compares them with
+//  network::analyze() and with a union-find of the components.
+
+void check_stream(const thomas::edge_stream &stream, const thomas::network &network, const std::vector<test::road> &roads, const unsigned threads) {
+    const uint64_t reference = test::reference_reduce(roads);
+    std::vector<uint64_t> degrees, impacts;
+    std::vector<size_t> disposed;
+
+    CHECK(stream.number_of_shops() == network.number_of_shops());
+    CHECK(stream.number_of_edges() == 2 * roads.size());
+
+    //  Shops are registered in the same order by the network and the edge list
+    thomas::count_degrees(stream, degrees, threads);
+
+    for (size_t i = 0; i < stream.number_of_shops(); ++i) {
+        CHECK(stream.identifier_at(i) == network.identifier_at(i));
+        CHECK(degrees[i] == network.degree(i));
+    }
+
+    std::vector<size_t> expected_disposed;
+    const thomas::reduce_result expected = thomas::analyze(network, impacts, expected_disposed);
+    const thomas::reduce_result result = thomas::analyze(stream, impacts, disposed, threads);
+
+    CHECK(result.disposed() == reference);
+    CHECK(result.threshold == expected.threshold);
+    CHECK(result.required_impact == expected.required_impact);
+
+    //  Both report the disposed shops by index
+    std::sort(expected_disposed.begin(), expected_disposed.end());
+    CHECK(disposed == expected_disposed);
+
+    std::vector<test::road> indexed;
+
+    for (size_t i = 0; i < network.number_of_shops(); ++i) {
+        for (auto each : network.neighbors(i)) {
+            indexed.push_back({ i, each });
+        }
+    }
+
+    const std::vector<uint32_t> components = test::reference_components(network.number_of_shops(), indexed);
+    std::vector<uint32_t> labels;
+    size_t count = 0;
+
+    for (size_t i = 0; i < components.size(); ++i) {
+        count += components[i] == i ? 1 : 0;
+    }
+
+    CHECK(thomas::connected_components(stream, labels, threads) == count);
+    CHECK(labels == components);
+}
+
+void check_network(const std::vector<test::road> &roads, const unsigned threads) {
+    thomas::network network;
+    thomas::edge_list edges;
+
+    for (auto &each : roads) {
+        network.connect(each.first, each.second);
+        edges.connect(each.first, each.second);
+    }
+
+    //  Default partitions, partitions of four shops, and from another backend
+    thomas::edge_stream stream, small(thomas::stream_partition_bytes / 4), converted(thomas::stream_partition_bytes / 4);
+
+    CHECK(stream.assign(edges));
+    CHECK(small.assign(edges));
+    CHECK(converted.assign(network));
+
+    check_stream(stream, network, roads, threads);
+    check_stream(small, network, roads, threads);
+    check_stream(converted, network, roads, threads);
+}
+
+int main() {
+    std::mt19937_64 engine(74);
+
+    for (int round = 0; round < 200; ++round) {
+        //  Sparse enough for several components
+        const uint64_t num_shops = 2 + engine() % 80;
+
+        check_network(test::random_roads(engine, num_shops, 1 + engine() % num_shops), 1);
+        check_network(test::random_roads(engine, num_shops, 1 + engine() % 200), 1);
+    }
+
+    check_network(test::random_roads(engine, 100000, 80000, 1, 5), 4);
+    check_network({}, 1);
+
+    return test::report();
+}
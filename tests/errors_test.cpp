@@ -0,0 +1,114 @@
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include "thomas/thomas.hpp"
+#include "test_support.hpp"
+
+//  Checks the error policies of the loader: stopping at the first error,
+//  skipping up to the limit, and keeping only the first few messages.
+
+//  Two malformed roads out of five, the others make a path of four shops
+const std::string malformed = "4 5\n1 2\n1 x\n2 3\n3 4\n9 z\n";
+
+thomas::status load_text(const std::string &contents, thomas::network &network, thomas::error_buffer &errors,
+                         const thomas::header_mode header = thomas::header_mode::trust) {
+    const std::filesystem::path path = std::filesystem::temp_directory_path() / "thomas_errors_test.txt";
+
+    std::ofstream(path, std::ios::binary) << contents;
+
+    thomas::input in(path.c_str());
+    const thomas::status status = thomas::import(thomas::format::native, in, network, errors, header);
+
+    std::filesystem::remove(path);
+
+    return status;
+}
+
+void check_policies() {
+    //  Abort stops at the first malformed line
+    {
+        thomas::network network;
+        thomas::error_buffer errors(thomas::error_policy::abort);
+
+        CHECK(load_text(malformed, network, errors) == thomas::status::parse_error);
+        CHECK(errors.get_errors() == 1);
+        CHECK(errors.get_entries().size() == 1 && errors.get_entries()[0].line == 3);
+        CHECK(network.number_of_connections() == 2);
+    }
+
+    //  Skip reads on, and reports every malformed line
+    {
+        thomas::network network;
+        thomas::error_buffer errors(thomas::error_policy::skip);
+
+        CHECK(load_text(malformed, network, errors) == thomas::status::ok);
+        CHECK(errors.get_errors() == 2);
+        CHECK(errors.get_dropped() == 0);
+        CHECK(network.number_of_connections() == 6);
+        CHECK(network.reduce() == test::reference_reduce({ { 1, 2 }, { 2, 3 }, { 3, 4 } }));
+    }
+
+    //  The limit counts errors, exceeding it stops the loader
+    {
+        thomas::network network;
+        thomas::error_buffer errors(thomas::error_policy::skip, 16, 1);
+
+        CHECK(load_text(malformed, network, errors) == thomas::status::too_many_errors);
+        CHECK(errors.get_errors() == 2);
+    }
+
+    {
+        thomas::network network;
+        thomas::error_buffer errors(thomas::error_policy::skip, 16, 2);
+
+        CHECK(load_text(malformed, network, errors) == thomas::status::ok);
+    }
+
+    //  A mismatching header fails under either policy, after reading every road
+    for (auto policy : { thomas::error_policy::abort, thomas::error_policy::skip }) {
+        thomas::network network;
+        thomas::error_buffer errors(policy);
+
+        CHECK(load_text("5 4\n1 2\n2 3\n3 4\n", network, errors, thomas::header_mode::verify) == thomas::status::range_error);
+        CHECK(errors.get_errors() == (policy == thomas::error_policy::skip ? 2 : 1));
+        CHECK(network.number_of_connections() == 6);
+    }
+}
+
+void check_buffer() {
+    thomas::error_buffer errors(thomas::error_policy::skip, 2, 3);
+
+    CHECK(errors.report(1, thomas::status::parse_error, "first"));
+    errors.warn(2, thomas::status::range_error, "second");
+    CHECK(errors.report(3, thomas::status::parse_error, "third"));
+    CHECK(errors.report(4, thomas::status::range_error, "fourth"));
+    CHECK(!errors.report(5, thomas::status::parse_error, "fifth"));
+
+    CHECK(errors.stopped() == thomas::status::too_many_errors);
+    CHECK(errors.get_errors() == 4);
+    CHECK(errors.get_warnings() == 1);
+    CHECK(errors.get_entries().size() == 2);
+    CHECK(errors.get_dropped() == 3);
+
+    std::ostringstream printed;
+
+    printed << errors;
+    CHECK(printed.str() == "parsing error: line 1: first\nwarning: line 2: second\n... 3 more not shown\n");
+
+    //  Without a buffer, everything is counted as dropped
+    thomas::error_buffer uncounted(thomas::error_policy::abort, 0);
+
+    CHECK(!uncounted.report(0, thomas::status::io_error, "input"));
+    CHECK(uncounted.stopped() == thomas::status::io_error);
+    CHECK(uncounted.get_dropped() == 1);
+}
+
+int main() {
+    check_policies();
+    check_buffer();
+
+    return test::report();
+}
@@ -0,0 +1,124 @@
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <random>
+#include <vector>
+
+#include "thomas/thomas.hpp"
+#include "test_support.hpp"
+
+//  Compares the approximate reduction with network::reduce() on random
+//  networks: exact with a candidate per shop, and whenever it claims to be
+//  guaranteed with fewer. The sketches are checked against exact degrees.
+
+thomas::approximate_result reduce_approximately(const std::vector<test::road> &roads, const size_t capacity, const size_t sketch_width) {
+    thomas::heavy_hitters sketch(capacity, sketch_width);
+
+    while (sketch.needs_pass()) {
+        for (auto &each : roads) {
+            sketch.connect(each.first, each.second);
+        }
+
+        sketch.next_pass();
+    }
+
+    return sketch.result();
+}
+
+void check_network(const std::vector<test::road> &roads, const uint64_t num_shops) {
+    thomas::network network;
+
+    for (auto &each : roads) {
+        network.connect(each.first, each.second);
+    }
+
+    const thomas::reduce_result expected = network.analyze();
+    std::vector<uint64_t> expected_shops;
+
+    for (auto &shop : expected.shops) {
+        expected_shops.push_back(network.identifier_at(shop));
+    }
+
+    std::sort(expected_shops.begin(), expected_shops.end());
+
+    //  Every shop holds a counter, so nothing is estimated
+    thomas::approximate_result exact = reduce_approximately(roads, static_cast<size_t>(num_shops), 1 << 10);
+
+    std::sort(exact.shops.begin(), exact.shops.end());
+    CHECK(exact.threshold == expected.threshold);
+    CHECK(exact.required_impact == expected.required_impact);
+    CHECK(exact.shops == expected_shops);
+    CHECK(exact.disposed() == network.reduce());
+
+    const thomas::approximate_result bounded = reduce_approximately(roads, 1 + static_cast<size_t>(num_shops) / 8, 1 << 10);
+
+    if (bounded.guaranteed) {
+        CHECK(bounded.threshold == expected.threshold);
+        CHECK(bounded.disposed() == network.reduce());
+    }
+}
+
+void check_sketches(std::mt19937_64 &engine) {
+    thomas::space_saving summary(16);
+    thomas::count_min sketch(64);
+    std::map<uint64_t, uint64_t> counts;
+
+    for (int i = 0; i < 5000; ++i) {
+        //  Skewed towards the small identifiers
+        const uint64_t identifier = std::min(engine() % 200, engine() % 200);
+
+        summary.add(identifier);
+        sketch.add(identifier);
+        ++counts[identifier];
+    }
+
+    CHECK(summary.get_total() == 5000);
+
+    for (auto &each : summary.get_counters()) {
+        CHECK(each.count >= counts[each.identifier]);
+        CHECK(each.count - each.error <= counts[each.identifier]);
+    }
+
+    //  Identifiers above total / capacity hold a counter
+    for (auto &each : counts) {
+        const auto &counters = summary.get_counters();
+        const bool held = std::any_of(counters.begin(), counters.end(), [&each] (const auto &counter) {
+            return counter.identifier == each.first;
+        });
+
+        CHECK(sketch.estimate(each.first) >= each.second);
+        CHECK(held || each.second * summary.get_capacity() <= summary.get_total());
+    }
+}
+
+int main() {
+    std::mt19937_64 engine(71);
+
+    for (int round = 0; round < 200; ++round) {
+        const uint64_t num_shops = 2 + engine() % 60;
+
+        check_network(test::random_roads(engine, num_shops, 1 + engine() % 200), num_shops);
+    }
+
+    for (int round = 0; round < 10; ++round) {
+        check_network(test::random_roads(engine, 1000, 5000), 1000);
+    }
+
+    //  A hub well above the others is guaranteed with few candidates
+    std::vector<test::road> star;
+
+    for (uint64_t leaf = 2; leaf <= 500; ++leaf) {
+        star.push_back({ 1, leaf });
+        star.push_back({ leaf, 500 + leaf % 7 });
+    }
+
+    const thomas::approximate_result hub = reduce_approximately(star, 8, 1 << 10);
+
+    CHECK(hub.guaranteed);
+    CHECK(hub.threshold == 499);
+    CHECK(hub.disposed() == test::reference_reduce(star));
+
+    check_sketches(engine);
+
+    return test::report();
+}
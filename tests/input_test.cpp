@@ -0,0 +1,198 @@
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+#ifdef THOMAS_ENABLE_ZLIB
+#include <zlib.h>
+#endif
+
+#ifdef THOMAS_ENABLE_ZSTD
+#include <zstd.h>
+#endif
+
+#include "thomas/thomas.hpp"
+#include "test_support.hpp"
+
+//  Round trips inputs through gzip and zstd, over several chunks of the
+//  decoder, and checks that corrupt and truncated streams are reported.
+//  Without a library, its inputs should be refused with an error.
+
+const std::filesystem::path path = std::filesystem::temp_directory_path() / "thomas_input_test";
+
+void write_file(const std::string &bytes) {
+    std::ofstream(path, std::ios::binary).write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+}
+
+/**
+ read_lines()
+ Reads the file back line by line.
+
+ @return Whether every line matches and the reader didn't fail.
+ */
+bool read_lines(const std::vector<std::string> &expected, const thomas::input::compression kind) {
+    thomas::input in(path.c_str());
+    std::string line;
+    size_t count = 0;
+    bool matching = in.get_compression() == kind;
+
+    while (in.getline(line)) {
+        matching = matching && count < expected.size() && line == expected[count];
+        ++count;
+    }
+
+    return matching && count == expected.size() && !in.has_failed();
+}
+
+/**
+ check_damaged()
+ Reads a damaged copy of a compressed file to its end.
+
+ @return The error of the reader, empty when it didn't fail.
+ */
+std::string check_damaged(const std::string &bytes) {
+    write_file(bytes);
+
+    thomas::input in(path.c_str());
+    thomas::network network;
+    thomas::error_buffer errors;
+
+    CHECK(thomas::import(thomas::format::snap, in, network, errors) == thomas::status::io_error);
+
+    return in.get_error();
+}
+
+void check_roads(const std::vector<test::road> &roads, const std::string &compressed) {
+    write_file(compressed);
+
+    thomas::input in(path.c_str());
+    thomas::network network;
+    thomas::error_buffer errors;
+
+    CHECK(thomas::import(thomas::format::snap, in, network, errors) == thomas::status::ok);
+    CHECK(network.number_of_connections() == 2 * roads.size());
+    CHECK(network.reduce() == test::reference_reduce(roads));
+}
+
+#ifdef THOMAS_ENABLE_ZLIB
+std::string compress_gzip(const std::string &text) {
+    z_stream stream = {};
+    std::string out(compressBound(static_cast<uLong>(text.size())) + 64, '\0');
+
+    //  15 window bits with the gzip wrapper
+    deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY);
+    stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(text.data()));
+    stream.avail_in = static_cast<uInt>(text.size());
+    stream.next_out = reinterpret_cast<Bytef *>(out.data());
+    stream.avail_out = static_cast<uInt>(out.size());
+    deflate(&stream, Z_FINISH);
+    out.resize(stream.total_out);
+    deflateEnd(&stream);
+
+    return out;
+}
+#endif
+
+#ifdef THOMAS_ENABLE_ZSTD
+std::string compress_zstd(const std::string &text) {
+    ZSTD_CCtx *context = ZSTD_createCCtx();
+    std::string out(ZSTD_compressBound(text.size()), '\0');
+
+    //  With a checksum, as corruption could otherwise decode into other roads
+    ZSTD_CCtx_setParameter(context, ZSTD_c_checksumFlag, 1);
+    out.resize(ZSTD_compress2(context, out.data(), out.size(), text.data(), text.size()));
+    ZSTD_freeCCtx(context);
+
+    return out;
+}
+#endif
+
+int main() {
+    std::mt19937_64 engine(51);
+
+    //  A few MiB of roads, several chunks of the decoder
+    const std::vector<test::road> roads = test::random_roads(engine, 100000, 400000);
+    std::vector<std::string> lines;
+    std::string text;
+
+    for (auto &each : roads) {
+        lines.push_back(std::to_string(each.first) + " " + std::to_string(each.second));
+        text += lines.back() + "\n";
+    }
+
+    write_file(text);
+    CHECK(read_lines(lines, thomas::input::compression::none));
+
+    //  A small zstd frame of a triangle, as written by the zstd tool
+    const unsigned char frame[] = {
+        0x28, 0xb5, 0x2f, 0xfd, 0x04, 0x58, 0x81, 0x00, 0x00, 0x33, 0x20, 0x33,
+        0x0a, 0x31, 0x20, 0x32, 0x0a, 0x32, 0x20, 0x33, 0x0a, 0x33, 0x20, 0x31,
+        0x0a, 0x6f, 0xaa, 0xf3, 0x51
+    };
+
+    write_file(std::string(reinterpret_cast<const char *>(frame), sizeof(frame)));
+
+#ifdef THOMAS_ENABLE_ZSTD
+    CHECK(read_lines({ "3 3", "1 2", "2 3", "3 1" }, thomas::input::compression::zstd));
+
+    const std::string zstd = compress_zstd(text);
+
+    check_roads(roads, zstd);
+    CHECK(read_lines(lines, thomas::input::compression::zstd));
+
+    std::string corrupt = zstd;
+
+    for (size_t i = corrupt.size() / 2; i < corrupt.size() / 2 + 64; ++i) {
+        corrupt[i] = static_cast<char>(corrupt[i] ^ 0x5a);
+    }
+
+    CHECK(check_damaged(corrupt).find("corrupt") != std::string::npos);
+    CHECK(check_damaged(zstd.substr(0, zstd.size() / 2)).find("truncated") != std::string::npos);
+#else
+    {
+        thomas::input in(path.c_str());
+
+        CHECK(in.get_compression() == thomas::input::compression::zstd);
+        CHECK(in.has_failed());
+    }
+#endif
+
+#ifdef THOMAS_ENABLE_ZLIB
+    const std::string gzip = compress_gzip(text);
+
+    check_roads(roads, gzip);
+    CHECK(read_lines(lines, thomas::input::compression::gzip));
+
+    //  Concatenated members read as a single stream
+    const std::string second = "7 8\n8 9\n";
+
+    write_file(compress_gzip(text) + compress_gzip(second));
+    lines.push_back("7 8");
+    lines.push_back("8 9");
+    CHECK(read_lines(lines, thomas::input::compression::gzip));
+
+    std::string corrupt_gzip = gzip;
+
+    for (size_t i = corrupt_gzip.size() / 2; i < corrupt_gzip.size() / 2 + 64; ++i) {
+        corrupt_gzip[i] = static_cast<char>(corrupt_gzip[i] ^ 0x5a);
+    }
+
+    CHECK(check_damaged(corrupt_gzip).find("corrupt") != std::string::npos);
+    CHECK(check_damaged(gzip.substr(0, gzip.size() / 2)).find("truncated") != std::string::npos);
+#else
+    write_file(std::string("\x1f\x8b", 2) + text);
+
+    {
+        thomas::input in(path.c_str());
+
+        CHECK(in.get_compression() == thomas::input::compression::gzip);
+        CHECK(in.has_failed());
+    }
+#endif
+
+    std::filesystem::remove(path);
+
+    return test::report();
+}
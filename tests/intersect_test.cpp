@@ -0,0 +1,144 @@
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <random>
+#include <set>
+#include <vector>
+
+#include "thomas/thomas.hpp"
+#include "test_support.hpp"
+
+//  Compares the search and intersection of sorted indices with the standard
+//  algorithms, over sizes around the block of four values, then checks the
+//  neighbor lists of finalized networks against sets of neighbors.
+
+std::vector<uint32_t> random_sorted(std::mt19937_64 &engine, const size_t size, const uint32_t range) {
+    std::vector<uint32_t> values(size);
+
+    for (auto &each : values) {
+        each = static_cast<uint32_t>(engine() % range);
+    }
+
+    std::sort(values.begin(), values.end());
+
+    return values;
+}
+
+void check_lower_bound(std::mt19937_64 &engine) {
+    for (size_t size = 0; size <= 40; ++size) {
+        for (const uint32_t range : { 4u, 64u, 1u << 20 }) {
+            const std::vector<uint32_t> values = random_sorted(engine, size, range);
+
+            for (uint32_t value = 0; value <= std::min(range, 80u); ++value) {
+                const size_t expected = static_cast<size_t>(std::lower_bound(values.begin(), values.end(), value) - values.begin());
+
+                CHECK(thomas::lower_bound_branchless(values.data(), values.size(), value) == expected);
+            }
+
+            CHECK(thomas::lower_bound_branchless(values.data(), values.size(), UINT32_MAX) == (size != 0 && values.back() == UINT32_MAX ? size - 1 : size));
+        }
+    }
+}
+
+void check_intersection(const std::vector<uint32_t> &a, const std::vector<uint32_t> &b) {
+    std::vector<uint32_t> unique_a = a, unique_b = b, expected;
+
+    unique_a.erase(std::unique(unique_a.begin(), unique_a.end()), unique_a.end());
+    unique_b.erase(std::unique(unique_b.begin(), unique_b.end()), unique_b.end());
+    std::set_intersection(unique_a.begin(), unique_a.end(), unique_b.begin(), unique_b.end(), std::back_inserter(expected));
+
+    std::vector<uint32_t> out(std::min(a.size(), b.size()));
+
+    out.resize(thomas::intersect_sorted(a.data(), a.size(), b.data(), b.size(), out.data()));
+    CHECK(out == expected);
+}
+
+void check_intersections(std::mt19937_64 &engine) {
+    //  Every pair of sizes up to a few blocks, sparse and with duplicates
+    for (size_t size_a = 0; size_a <= 13; ++size_a) {
+        for (size_t size_b = 0; size_b <= 13; ++size_b) {
+            for (const uint32_t range : { 3u, 16u, 64u }) {
+                for (int repeat = 0; repeat < 8; ++repeat) {
+                    check_intersection(random_sorted(engine, size_a, range), random_sorted(engine, size_b, range));
+                }
+            }
+        }
+    }
+
+    //  Long and lopsided arrays
+    for (int repeat = 0; repeat < 200; ++repeat) {
+        const size_t size_a = engine() % 1000;
+        const size_t size_b = engine() % 1000;
+        const uint32_t range = 1 + static_cast<uint32_t>(engine() % 4000);
+
+        check_intersection(random_sorted(engine, size_a, range), random_sorted(engine, size_b, range));
+    }
+
+    check_intersection({ 0, UINT32_MAX }, { UINT32_MAX });
+    check_intersection({ 7, 7, 7, 7, 7, 7, 7, 7, 7 }, { 7, 7, 7, 7, 7 });
+}
+
+void check_network(std::mt19937_64 &engine, const uint64_t num_shops, const size_t num_roads) {
+    const std::vector<test::road> roads = test::random_roads(engine, num_shops, num_roads);
+    thomas::network network;
+
+    for (auto &each : roads) {
+        network.connect(each.first, each.second);
+    }
+
+    std::vector<std::set<uint32_t>> expected(network.number_of_shops());
+
+    for (size_t i = 0; i < network.number_of_shops(); ++i) {
+        for (auto neighbor : network.neighbors(i)) {
+            expected[i].insert(static_cast<uint32_t>(neighbor));
+        }
+    }
+
+    //  The linear scan, before and after finalize()
+    for (int pass = 0; pass < 2; ++pass) {
+        for (size_t a = 0; a < network.number_of_shops(); ++a) {
+            for (size_t b = 0; b < network.number_of_shops(); ++b) {
+                CHECK(network.has_edge(a, b) == (expected[a].count(static_cast<uint32_t>(b)) != 0));
+            }
+        }
+
+        if (pass == 0) {
+            network.finalize();
+            CHECK(network.is_finalized());
+        }
+    }
+
+    std::vector<uint32_t> common;
+
+    for (size_t a = 0; a < network.number_of_shops(); ++a) {
+        const thomas::index_neighbors sorted = network.sorted_neighbors(a);
+
+        CHECK(std::vector<uint32_t>(sorted.begin(), sorted.end()) == std::vector<uint32_t>(expected[a].begin(), expected[a].end()));
+
+        for (size_t b = 0; b < network.number_of_shops(); ++b) {
+            std::vector<uint32_t> both;
+
+            std::set_intersection(expected[a].begin(), expected[a].end(), expected[b].begin(), expected[b].end(), std::back_inserter(both));
+            CHECK(network.common_neighbors(a, b, common) == both.size());
+            CHECK(common == both);
+        }
+    }
+
+    //  Connecting again undoes it
+    network.connect(1, 2);
+    CHECK(!network.is_finalized());
+}
+
+int main() {
+    std::mt19937_64 engine(67);
+
+    check_lower_bound(engine);
+    check_intersections(engine);
+
+    check_network(engine, 1, 4);
+    check_network(engine, 12, 30);
+    check_network(engine, 40, 400);
+    check_network(engine, 150, 3000);
+
+    return test::report();
+}
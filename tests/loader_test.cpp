@@ -0,0 +1,152 @@
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include "thomas/thomas.hpp"
+#include "test_support.hpp"
+
+//  Checks how the importers read edge cases of their formats, with the
+//  input written to a temporary file.
+
+template <typename Network>
+thomas::status load_text(const std::string &contents, const thomas::format format, Network &network,
+                         const thomas::header_mode header = thomas::header_mode::trust,
+                         const thomas::error_policy policy = thomas::error_policy::abort) {
+    const std::filesystem::path path = std::filesystem::temp_directory_path() / "thomas_loader_test.txt";
+
+    std::ofstream(path, std::ios::binary) << contents;
+
+    thomas::input in(path.c_str());
+    thomas::error_buffer errors(policy, 0);
+    const thomas::status status = thomas::import(format, in, network, errors, header);
+
+    std::filesystem::remove(path);
+
+    return status;
+}
+
+void check_native() {
+    //  A loop lists its shop twice, even for a shop first seen on the loop
+    {
+        thomas::network network;
+
+        CHECK(load_text("3 3\n5 5\n5 6\n6 7\n", thomas::format::native, network) == thomas::status::ok);
+        CHECK(network.number_of_shops() == 3);
+        CHECK(network.degree(0) == 3);
+        CHECK(network.reduce() == test::reference_reduce({ { 5, 5 }, { 5, 6 }, { 6, 7 } }));
+    }
+
+    //  Numbers are whole blank separated fields, a sign or a suffix is an error
+    for (const char *line : { "1 2x", "-1 5", "1 +2", "1" }) {
+        thomas::network network;
+
+        CHECK(load_text(std::string("2 1\n") + line + "\n", thomas::format::native, network) == thomas::status::parse_error);
+    }
+
+    //  Trailing fields after the pair are ignored
+    {
+        thomas::network network;
+
+        CHECK(load_text("2 1\n1 2 7\n", thomas::format::native, network) == thomas::status::ok);
+        CHECK(network.number_of_connections() == 2);
+    }
+
+    //  A trusted header stops after the declared roads, the other modes read on
+    {
+        thomas::network trusted, verified;
+
+        CHECK(load_text("2 1\n1 2\n2 3\n", thomas::format::native, trusted) == thomas::status::ok);
+        CHECK(trusted.number_of_connections() == 2);
+        CHECK(load_text("2 1\n1 2\n2 3\n", thomas::format::native, verified, thomas::header_mode::verify) == thomas::status::range_error);
+        CHECK(verified.number_of_connections() == 4);
+    }
+}
+
+//  Declared counts beyond what can be stored are only trusted when asked to
+template <typename Network>
+void check_declared_counts() {
+    {
+        Network network;
+
+        CHECK(load_text("99999999999999 1\n1 2\n", thomas::format::native, network, thomas::header_mode::verify) == thomas::status::range_error);
+        CHECK(network.number_of_shops() == 2);
+    }
+
+    {
+        Network network;
+
+        CHECK(load_text("3 1000000000000\n1 2\n2 3\n", thomas::format::native, network, thomas::header_mode::verify) == thomas::status::range_error);
+        CHECK(network.number_of_shops() == 3);
+    }
+
+    {
+        Network network;
+
+        CHECK(load_text("99999999999999 1\n2\n1\n", thomas::format::metis, network) != thomas::status::ok);
+    }
+
+    {
+        Network network;
+
+        CHECK(load_text("%%MatrixMarket matrix coordinate pattern symmetric\n99999999999 99999999999 1\n2 1\n", thomas::format::matrix_market, network) == thomas::status::ok);
+        CHECK(network.number_of_shops() == 2);
+    }
+}
+
+//  Declared counts above the default bound are reserved for when asked to
+void check_reservation() {
+    const std::filesystem::path path = std::filesystem::temp_directory_path() / "thomas_loader_test.mtx";
+    const uint64_t declared = 3 * thomas::default_max_reservation;
+
+    std::ofstream(path, std::ios::binary) << "%%MatrixMarket matrix coordinate pattern symmetric\n" << declared << " " << declared << " 1\n2 1\n";
+
+    for (const uint64_t max_reservation : { thomas::default_max_reservation, declared, uint64_t(UINT64_MAX) }) {
+        thomas::network network;
+        thomas::input in(path.c_str());
+        thomas::error_buffer errors(thomas::error_policy::abort, 0);
+
+        CHECK(thomas::import(thomas::format::matrix_market, in, network, errors, thomas::header_mode::trust, max_reservation) == thomas::status::ok);
+        CHECK(network.number_of_shops() == 2);
+        CHECK((network.get_shops().capacity() >= declared) == (max_reservation >= declared));
+    }
+
+    std::filesystem::remove(path);
+
+    //  Without a bound, counts which can't be stored fail the import
+    thomas::network network;
+    thomas::error_buffer errors(thomas::error_policy::abort, 0);
+
+    std::ofstream(path, std::ios::binary) << "99999999999999999 1\n2\n1\n";
+
+    thomas::input in(path.c_str());
+
+    CHECK(thomas::import(thomas::format::metis, in, network, errors, thomas::header_mode::trust, UINT64_MAX) == thomas::status::range_error);
+
+    std::filesystem::remove(path);
+}
+
+void check_formats() {
+    thomas::network metis, mtx, snap;
+
+    CHECK(load_text("% comment\n3 2\n2 3\n1\n1\n", thomas::format::metis, metis) == thomas::status::ok);
+    CHECK(metis.number_of_connections() == 4);
+
+    CHECK(load_text("%%MatrixMarket matrix coordinate pattern symmetric\n3 3 2\n2 1\n3 3\n", thomas::format::matrix_market, mtx) == thomas::status::ok);
+    CHECK(mtx.number_of_connections() == 4);
+    CHECK(mtx.degree(2) == 2);
+
+    CHECK(load_text("# comment\n1 2\n1 2\n\n3 3\n", thomas::format::snap, snap) == thomas::status::ok);
+    CHECK(snap.number_of_connections() == 6);
+    CHECK(snap.reduce() == test::reference_reduce({ { 1, 2 }, { 1, 2 }, { 3, 3 } }));
+}
+
+int main() {
+    check_native();
+    check_declared_counts<thomas::network>();
+    check_declared_counts<thomas::edge_list>();
+    check_reservation();
+    check_formats();
+
+    return test::report();
+}
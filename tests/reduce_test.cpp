@@ -0,0 +1,163 @@
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "thomas/thomas.hpp"
+#include "test_support.hpp"
+
+//  Differential test of every reduction against the definition of the
+//  original network::reduce(), over random networks with loops and parallel
+//  roads, simple dense ones, and a few large enough to be split in threads.
+
+template <typename Compressed>
+uint64_t reduce_compressed(const thomas::edge_list &edges) {
+    Compressed compressed;
+    std::vector<uint64_t> impacts;
+    std::vector<size_t> disposed;
+
+    if (!CHECK(compressed.assign(edges))) {
+        return UINT64_MAX;
+    }
+
+    return thomas::analyze(compressed, impacts, disposed).disposed();
+}
+
+void check_network(const std::vector<test::road> &roads, thomas::graph_batch &batch, std::vector<uint64_t> &expected) {
+    const uint64_t reference = test::reference_reduce(roads);
+    thomas::network network;
+    thomas::edge_list edges;
+
+    for (auto &each : roads) {
+        network.connect(each.first, each.second);
+        edges.connect(each.first, each.second);
+    }
+
+    CHECK(network.reduce() == reference);
+    CHECK(network.reduce() == reference);
+    CHECK(network.reduce_connections() == reference);
+
+    thomas::reduce_workspace workspace;
+    CHECK(network.reduce(workspace) == reference);
+
+    const thomas::reduce_result result = network.analyze();
+    CHECK(result.disposed() == reference);
+    CHECK(result.count == result.shops.size());
+
+    for (auto &shop : result.shops) {
+        CHECK(network.degree(shop) == result.threshold);
+        CHECK(network.external_impact(shop, result.threshold) == result.required_impact);
+    }
+
+    //  Once finalized, small and dense simple networks reduce over their matrix
+    network.finalize();
+    CHECK(network.reduce() == reference);
+    CHECK(network.reduce(workspace) == reference);
+
+    CHECK(reduce_compressed<thomas::csr_network<uint32_t, uint32_t>>(edges) == reference);
+    CHECK(reduce_compressed<thomas::csr_network<uint64_t, uint32_t>>(edges) == reference);
+    CHECK(reduce_compressed<thomas::csr_network<uint64_t, uint64_t>>(edges) == reference);
+
+    CHECK(thomas::visit_narrowest(edges, [] (const auto &compressed) {
+        std::vector<uint64_t> impacts;
+        std::vector<size_t> disposed;
+
+        return thomas::analyze(compressed, impacts, disposed).disposed();
+    }) == reference);
+
+    //  The matrix only takes simple networks
+    thomas::dense_network dense;
+
+    if (network.number_of_shops() <= thomas::dense_network::max_shops && dense.assign(network.get_shops())) {
+        CHECK(dense.reduce() == reference);
+    }
+
+    batch.add_network(network);
+    expected.push_back(reference);
+}
+
+//  The threads of order_by_degree() place their ranges as the serial order
+void check_order(const std::vector<test::road> &roads) {
+    thomas::network network;
+
+    for (auto &each : roads) {
+        network.connect(each.first, each.second);
+    }
+
+    std::vector<thomas::shop *> serial, parallel;
+    std::vector<size_t> counts;
+
+    network.order_by_degree(serial, counts, 1);
+
+    CHECK(serial.size() == network.number_of_shops());
+    CHECK(std::is_sorted(serial.begin(), serial.end(), [] (thomas::shop *lhs, thomas::shop *rhs) {
+        const size_t left = lhs->get_connected_shops().size(), right = rhs->get_connected_shops().size();
+
+        return left != right ? left > right : lhs->get_index() < rhs->get_index();
+    }));
+
+    for (const unsigned threads : { 2u, 3u, 8u }) {
+        network.order_by_degree(parallel, counts, threads);
+        CHECK(parallel == serial);
+    }
+}
+
+int main() {
+    std::mt19937_64 engine(2018);
+    thomas::graph_batch batch;
+    std::vector<uint64_t> expected;
+
+    CHECK(thomas::network().reduce() == 0);
+
+    for (int round = 0; round < 300; ++round) {
+        const uint64_t num_shops = 2 + engine() % 60;
+        const size_t num_roads = 1 + engine() % 200;
+
+        check_network(test::random_roads(engine, num_shops, num_roads), batch, expected);
+        check_network(test::random_roads(engine, num_shops, num_roads, 0, 0), batch, expected);
+    }
+
+    for (int round = 0; round < 40; ++round) {
+        check_network(test::random_roads(engine, 1000, 1000), batch, expected);
+    }
+
+    //  Networks with a tie at the threshold of a few shops
+    check_network({ { 1, 2 }, { 2, 3 }, { 3, 1 } }, batch, expected);
+    check_network({ { 1, 2 }, { 3, 4 } }, batch, expected);
+    check_network({ { 1, 1 }, { 2, 2 } }, batch, expected);
+    check_network({ { 1, 2 }, { 1, 2 }, { 3, 3 } }, batch, expected);
+
+    std::vector<test::road> complete;
+
+    for (uint64_t a = 1; a <= 20; ++a) {
+        for (uint64_t b = a + 1; b <= 20; ++b) {
+            complete.push_back({ a, b });
+        }
+    }
+
+    check_network(complete, batch, expected);
+
+    std::vector<uint64_t> results(batch.size());
+    thomas::reduce_batch(batch, results.data(), 4);
+    CHECK(results == expected);
+
+    for (int round = 0; round < 3; ++round) {
+        thomas::graph_batch unused;
+        std::vector<uint64_t> ignored;
+
+        check_network(test::random_roads(engine, 100000, 250000, 1, 5), unused, ignored);
+    }
+
+    check_order(test::random_roads(engine, 100000, 250000));
+
+    //  A hub, whose degree leaves fewer histograms than threads
+    std::vector<test::road> hub = test::random_roads(engine, 70000, 100000);
+
+    for (uint64_t shop = 2; shop <= 40000; ++shop) {
+        hub.push_back({ 1, shop });
+    }
+
+    check_order(hub);
+
+    return test::report();
+}
@@ -0,0 +1,90 @@
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "thomas/thomas.hpp"
+#include "test_support.hpp"
+
+//  Compares small_network::reduce() with the definition of the original
+//  network::reduce(), at compile time on fixed networks and at run time on
+//  random ones filling its capacity.
+
+template <size_t Shops, size_t Roads>
+constexpr uint64_t reduce_small(const std::initializer_list<test::road> roads) {
+    thomas::small_network<Shops, Roads> network;
+
+    for (auto &each : roads) {
+        network.connect(each.first, each.second);
+    }
+
+    return network.reduce();
+}
+
+static_assert(reduce_small<8, 8>({}) == 0);
+static_assert(reduce_small<8, 8>({ { 1, 2 }, { 2, 3 }, { 3, 1 } }) == 3);
+static_assert(reduce_small<8, 8>({ { 1, 2 }, { 3, 4 } }) == 4);
+static_assert(reduce_small<8, 8>({ { 1, 2 }, { 1, 3 } }) == 0);
+static_assert(reduce_small<8, 8>({ { 1, 1 }, { 2, 2 } }) == 2);
+static_assert(reduce_small<8, 8>({ { 1, 2 }, { 1, 2 }, { 3, 3 } }) == 3);
+
+template <size_t Shops, size_t Roads>
+void check_random(std::mt19937_64 &engine, thomas::small_network<Shops, Roads> &small, const uint64_t num_shops, const size_t num_roads) {
+    const std::vector<test::road> roads = test::random_roads(engine, num_shops, num_roads);
+    thomas::network network;
+
+    small.clear();
+
+    for (auto &each : roads) {
+        CHECK(small.connect(each.first, each.second));
+        network.connect(each.first, each.second);
+    }
+
+    CHECK(small.number_of_shops() == network.number_of_shops());
+    CHECK(small.reduce() == test::reference_reduce(roads));
+    CHECK(small.reduce() == network.reduce());
+}
+
+int main() {
+    std::mt19937_64 engine(58);
+
+    //  On the stack as intended, about 145 KiB for the larger one
+    thomas::small_network<64, 256> small;
+    thomas::small_network<1000, 1000> large;
+
+    for (int round = 0; round < 300; ++round) {
+        check_random(engine, small, 2 + engine() % 62, 1 + engine() % 256);
+    }
+
+    for (int round = 0; round < 20; ++round) {
+        check_random(engine, large, 1000, 1000);
+    }
+
+    //  Roads beyond either capacity are refused
+    thomas::small_network<2, 2> tiny;
+
+    CHECK(tiny.connect(1, 2));
+    CHECK(!tiny.connect(1, 3));
+    CHECK(tiny.connect(2, 2));
+    CHECK(!tiny.connect(1, 2));
+    CHECK(tiny.reduce() == test::reference_reduce({ { 1, 2 }, { 2, 2 } }));
+
+    //  A road whose second end doesn't fit registers neither
+    thomas::small_network<3, 4> full;
+
+    CHECK(full.connect(1, 2));
+    CHECK(!full.connect(3, 4));
+    CHECK(full.number_of_shops() == 2);
+    CHECK(full.find(3) == full.npos);
+    CHECK(full.connect(3, 3));
+    CHECK(!full.connect(4, 4));
+    CHECK(full.number_of_shops() == 3);
+    CHECK(full.reduce() == test::reference_reduce({ { 1, 2 }, { 3, 3 } }));
+
+    //  Cleared networks reuse their capacity
+    full.clear();
+    CHECK(full.find(1) == full.npos);
+    CHECK(full.connect(4, 5) && full.connect(5, 6) && full.connect(6, 4));
+    CHECK(full.reduce() == 3);
+
+    return test::report();
+}
@@ -0,0 +1,100 @@
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "thomas/thomas.hpp"
+#include "test_support.hpp"
+
+//  Streams random timed roads through temporal_network, and compares every
+//  reduction with a network of the roads still within the window.
+
+struct timed_road {
+    uint64_t timestamp;
+    test::road road;
+};
+
+void check_window(thomas::temporal_network &temporal, const std::vector<timed_road> &history, const uint64_t now, const uint64_t window) {
+    std::vector<test::road> live;
+    thomas::network network;
+
+    for (auto &each : history) {
+        if (now < window || each.timestamp > now - window) {
+            live.push_back(each.road);
+            network.connect(each.road.first, each.road.second);
+        }
+    }
+
+    CHECK(temporal.number_of_roads() == live.size());
+    CHECK(temporal.reduce() == test::reference_reduce(live));
+
+    const thomas::reduce_result result = temporal.analyze();
+    const thomas::reduce_result expected = network.analyze();
+    std::vector<uint64_t> shops, expected_shops;
+
+    for (auto &shop : result.shops) {
+        shops.push_back(temporal.identifier_at(shop));
+    }
+
+    for (auto &shop : expected.shops) {
+        expected_shops.push_back(network.identifier_at(shop));
+    }
+
+    std::sort(shops.begin(), shops.end());
+    std::sort(expected_shops.begin(), expected_shops.end());
+
+    CHECK(result.threshold == (live.empty() ? 0 : expected.threshold));
+    CHECK(shops == (live.empty() ? std::vector<uint64_t>() : expected_shops));
+
+    //  Shops keep their index once expired, at a degree of zero
+    for (size_t i = 0; i < temporal.number_of_shops(); ++i) {
+        const uint64_t identifier = temporal.identifier_at(i);
+        uint64_t degree = 0;
+
+        for (auto &each : live) {
+            degree += (each.first == identifier) + (each.second == identifier);
+        }
+
+        CHECK(temporal.degree(i) == degree);
+    }
+}
+
+void check_stream(std::mt19937_64 &engine, const uint64_t num_shops, const uint64_t window, const size_t batch_size) {
+    thomas::temporal_network temporal(window, batch_size);
+    std::vector<timed_road> history;
+    uint64_t now = 0;
+
+    for (const test::road &each : test::random_roads(engine, num_shops, 400)) {
+        //  Several roads may share a timestamp
+        now += engine() % 3;
+
+        CHECK(temporal.add(now, each.first, each.second));
+        history.push_back({ now, each });
+        check_window(temporal, history, now, window);
+    }
+
+    CHECK(!temporal.add(now - 1, 1, 2));
+
+    //  Moving on without roads expires the window from the oldest batch on
+    for (uint64_t step = 0; step <= window; step += 1 + window / 8) {
+        temporal.advance(now + step);
+        check_window(temporal, history, now + step, window);
+    }
+
+    temporal.advance(now + window);
+    CHECK(temporal.number_of_roads() == 0);
+    CHECK(temporal.get_max_degree() == 0);
+    CHECK(temporal.reduce() == 0);
+}
+
+int main() {
+    std::mt19937_64 engine(72);
+
+    for (int round = 0; round < 20; ++round) {
+        check_stream(engine, 2 + engine() % 30, 1 + engine() % 60, 1 + engine() % 16);
+    }
+
+    check_stream(engine, 200, 1000, 4096);
+
+    return test::report();
+}
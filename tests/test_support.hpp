@@ -0,0 +1,146 @@
+#ifndef THOMAS_TEST_SUPPORT_HPP
+#define THOMAS_TEST_SUPPORT_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <map>
+#include <random>
+#include <utility>
+#include <vector>
+
+//  Tests are plain executables: every failed check is printed, and the exit
+//  code is the number of failures, so ctest reports any of them.
+#define CHECK(...) test::check((__VA_ARGS__), #__VA_ARGS__, __FILE__, __LINE__)
+
+namespace test {
+    using road = std::pair<uint64_t, uint64_t>;
+
+    inline int failures = 0;
+
+    inline bool check(const bool passed, const char *condition, const char *file, const int line) {
+        if (!passed) {
+            std::cerr << file << ":" << line << ": check failed: " << condition << std::endl;
+            ++failures;
+        }
+
+        return passed;
+    }
+
+    inline int report() {
+        return std::min(failures, 255);
+    }
+
+    /**
+     random_roads()
+     Roads in between shops 1 to num_shops, with a share of loops and of
+     roads repeating an earlier one, as the importers accept both.
+     */
+    inline std::vector<road> random_roads(std::mt19937_64 &engine, const uint64_t num_shops, const size_t num_roads, const unsigned loop_percent = 10, const unsigned repeat_percent = 10) {
+        std::vector<road> roads;
+
+        roads.reserve(num_roads);
+
+        for (size_t r = 0; r < num_roads; ++r) {
+            const unsigned kind = static_cast<unsigned>(engine() % 100);
+
+            if (kind < repeat_percent && !roads.empty()) {
+                roads.push_back(roads[engine() % roads.size()]);
+            } else if (kind < repeat_percent + loop_percent) {
+                const uint64_t shop = 1 + engine() % num_shops;
+                roads.push_back({ shop, shop });
+            } else {
+                roads.push_back({ 1 + engine() % num_shops, 1 + engine() % num_shops });
+            }
+        }
+
+        return roads;
+    }
+
+    /**
+     reference_reduce()
+     The reduction of the original network::reduce(), written directly from
+     its definition: a loop lists its shop twice, parallel roads are kept, and
+     an impact sums the degrees of the neighbors outside of the tie set.
+
+     @return The number of nodes disposed.
+     */
+    inline uint64_t reference_reduce(const std::vector<road> &roads) {
+        std::map<uint64_t, std::vector<uint64_t>> connections;
+
+        for (auto &each : roads) {
+            connections[each.second].push_back(each.first);
+            connections[each.first].push_back(each.second);
+        }
+
+        if (connections.empty()) {
+            return 0;
+        }
+
+        size_t threshold = 0;
+
+        for (auto &each : connections) {
+            threshold = std::max(threshold, each.second.size());
+        }
+
+        std::vector<uint64_t> impacts;
+
+        for (auto &each : connections) {
+            if (each.second.size() != threshold) {
+                continue;
+            }
+
+            uint64_t impact = 0;
+
+            for (auto &neighbor : each.second) {
+                const size_t degree = connections[neighbor].size();
+                impact += degree < threshold ? degree : 0;
+            }
+
+            impacts.push_back(impact);
+        }
+
+        const uint64_t required_impact = *std::max_element(impacts.begin(), impacts.end());
+        const uint64_t count = static_cast<uint64_t>(std::count(impacts.begin(), impacts.end(), required_impact));
+
+        return count < 2 ? 0 : count;
+    }
+
+    /**
+     reference_components()
+     Smallest index in the component of every shop, with a union-find over
+     the roads given by shop index, the smaller root always kept.
+
+     @return The label of every shop.
+     */
+    inline std::vector<uint32_t> reference_components(const size_t num_shops, const std::vector<road> &roads) {
+        std::vector<uint32_t> parents(num_shops);
+
+        for (size_t i = 0; i < num_shops; ++i) {
+            parents[i] = static_cast<uint32_t>(i);
+        }
+
+        const auto find = [&parents] (uint32_t i) {
+            while (parents[i] != i) {
+                i = parents[i] = parents[parents[i]];
+            }
+
+            return i;
+        };
+
+        for (auto &each : roads) {
+            const uint32_t a = find(static_cast<uint32_t>(each.first));
+            const uint32_t b = find(static_cast<uint32_t>(each.second));
+
+            parents[std::max(a, b)] = std::min(a, b);
+        }
+
+        for (size_t i = 0; i < num_shops; ++i) {
+            parents[i] = find(static_cast<uint32_t>(i));
+        }
+
+        return parents;
+    }
+}
+
+#endif
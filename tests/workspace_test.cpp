@@ -0,0 +1,61 @@
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "thomas/thomas.hpp"
+#include "test_support.hpp"
+
+//  Reduces the same network repeatedly with a single workspace, which should
+//  only grow on the first call, over the connection lists and the matrix.
+
+void check_growths(const std::vector<test::road> &roads, const bool finalize) {
+    const uint64_t reference = test::reference_reduce(roads);
+    thomas::network network;
+
+    for (auto &each : roads) {
+        network.connect(each.first, each.second);
+    }
+
+    if (finalize) {
+        network.finalize();
+    }
+
+    thomas::reduce_workspace workspace;
+
+    CHECK(network.reduce(workspace) == reference);
+
+    const uint64_t growths = workspace.get_growths();
+
+    CHECK(growths <= 1);
+
+    for (int call = 0; call < 10; ++call) {
+        CHECK(network.reduce(workspace) == reference);
+        CHECK(workspace.get_growths() == growths);
+    }
+
+    thomas::reduce_workspace analysis;
+
+    CHECK(network.analyze(analysis).disposed() == reference);
+
+    const uint64_t analysis_growths = analysis.get_growths();
+
+    for (int call = 0; call < 10; ++call) {
+        CHECK(network.analyze(analysis).disposed() == reference);
+        CHECK(analysis.get_growths() == analysis_growths);
+    }
+}
+
+int main() {
+    std::mt19937_64 engine(61);
+
+    for (int round = 0; round < 50; ++round) {
+        const std::vector<test::road> roads = test::random_roads(engine, 2 + engine() % 60, 1 + engine() % 200);
+
+        check_growths(roads, false);
+        check_growths(roads, true);
+    }
+
+    check_growths(test::random_roads(engine, 100000, 250000, 1, 5), false);
+
+    return test::report();
+}
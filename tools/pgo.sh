@@ -0,0 +1,81 @@
+#!/bin/sh
+#   Builds thomas with profile-guided optimization and compares it with a
+#   regular Release build.
+#
+#   1. Release build, which also provides thomas_generate
+#   2. Synthetic training networks: assignment sized ones and large ones
+#   3. Instrumented build (THOMAS_PGO=GENERATE), thomas and thomas_bench run
+#      over the training set, as profiles are kept by object file
+#   4. Optimized build (THOMAS_PGO=USE) in the same tree
+#   5. Optional BOLT layout when llvm-bolt, perf2bolt and perf are available
+#   6. thomas_bench of both builds over a separate benchmark set
+#
+#   Usage: tools/pgo.sh [work directory], CXX selects the compiler.
+
+set -eu
+
+root=$(cd "$(dirname "$0")/.." && pwd)
+work=${1:-"$root/build/pgo-work"}
+jobs=$(nproc 2>/dev/null || echo 4)
+profiles="$work/profiles"
+
+mkdir -p "$work/train" "$work/bench"
+rm -rf "$profiles"
+
+cmake -S "$root" -B "$work/release" -DCMAKE_BUILD_TYPE=Release >/dev/null
+cmake --build "$work/release" -j "$jobs" >/dev/null
+
+generate="$work/release/thomas_generate"
+
+#   Training inputs, the assignment sized networks dominate the workload
+seed=1
+while [ $seed -le 24 ]; do
+    "$generate" --shops=1000 --roads=1000 --seed=$seed --skew=$((seed % 3 + 1)) > "$work/train/small-$seed.txt"
+    seed=$((seed + 1))
+done
+
+"$generate" --format=snap --shops=200000 --roads=2000000 --seed=101 --skew=2 > "$work/train/large.snap"
+"$generate" --format=metis --shops=100000 --roads=1000000 --seed=102 --skew=2 > "$work/train/large.graph"
+"$generate" --format=mtx --shops=100000 --roads=1000000 --seed=103 > "$work/train/large.mtx"
+
+#   Benchmark inputs, drawn with other seeds than the training ones
+"$generate" --shops=1000 --roads=1000 --seed=201 --skew=2 > "$work/bench/small.txt"
+"$generate" --format=snap --shops=1000000 --roads=8000000 --seed=202 --skew=2 > "$work/bench/large.snap"
+"$generate" --format=metis --shops=200000 --roads=2000000 --seed=203 --skew=1 > "$work/bench/large.graph"
+
+cmake -S "$root" -B "$work/pgo" -DCMAKE_BUILD_TYPE=Release -DTHOMAS_PGO=GENERATE -DTHOMAS_PGO_DIR="$profiles" >/dev/null
+cmake --build "$work/pgo" -j "$jobs" >/dev/null
+
+for input in "$work"/train/*; do
+    "$work/pgo/thomas" "$input" >/dev/null
+done
+
+"$work/pgo/thomas_bench" --repeat=1 "$work"/train/* >/dev/null
+
+#   Clang writes raw profiles which have to be merged first
+if ls "$profiles"/*.profraw >/dev/null 2>&1; then
+    llvm-profdata merge -output="$profiles/thomas.profdata" "$profiles"/*.profraw
+fi
+
+cmake -S "$root" -B "$work/pgo" -DTHOMAS_PGO=USE -DTHOMAS_BOLT=ON >/dev/null
+cmake --build "$work/pgo" -j "$jobs" >/dev/null
+
+bench="$work/pgo/thomas_bench"
+
+if command -v llvm-bolt >/dev/null && command -v perf2bolt >/dev/null && command -v perf >/dev/null; then
+    perf record -e cycles:u -j any,u -o "$work/perf.data" -- "$bench" --repeat=3 "$work"/train/* >/dev/null
+    perf2bolt -p "$work/perf.data" -o "$work/bolt.fdata" "$bench" >/dev/null
+    llvm-bolt "$bench" -o "$work/thomas_bench.bolt" -data="$work/bolt.fdata" \
+        -reorder-blocks=ext-tsp -reorder-functions=hfsort -split-functions -split-all-cold >/dev/null
+fi
+
+echo "== Release"
+"$work/release/thomas_bench" "$work"/bench/*
+
+echo "== Release + PGO"
+"$bench" "$work"/bench/*
+
+if [ -x "$work/thomas_bench.bolt" ]; then
+    echo "== Release + PGO + BOLT"
+    "$work/thomas_bench.bolt" "$work"/bench/*
+fi